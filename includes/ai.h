@@ -10,21 +10,287 @@
 
 // Includes
 #include "common_functions.h"
+#include "board_pool.h"
+#include "search_stats.h"
+#include "transposition_table.h"
+#include "tablebase.h"
 #include <string.h>
+#include <limits.h>
+#include <time.h>
+
+/** Soglia iniziale della ricerca: qualsiasi punteggio la supera */
+#define NO_SCORE (INT_MIN / 2)
+/** Ogni quante situazioni di gioco esplorate controllare se il tempo a disposizione è finito (potenza di 2) */
+#define TIME_CHECK_INTERVAL 1024
+/** Colonne allocate a sinistra della colonna 0 nelle copie del campo: una tessera sposta il campo al massimo di 2 */
+#define COPY_LEFT_COLS 2
+/** Risultato stampato come disegno del campo */
+#define OUTPUT_ASCII 0
+/** Risultato stampato con il campo in codifica run-length (renderBoardRLE) */
+#define OUTPUT_RLE 1
+/** Risultato stampato come riga JSON, come in modalità batch */
+#define OUTPUT_JSON 2
+
+/**
+ * Tipo di dato che contiene le opzioni della modalità AI
+ * @var pruning se scartare i sottoalberi che, anche mettendo tutte le tessere rimaste al massimo dei punti,
+ * non possono superare la migliore partita trovata
+ * @var inPlace se provare le mosse modificando e poi ripristinando un'unica situazione di gioco invece di
+ * copiarla per ogni mossa
+ * @var threads numero di thread tra cui dividere la ricerca
+ * @var budgetMs millisecondi a disposizione della ricerca, 0 se non c'è limite di tempo
+ * @var stats se stampare le statistiche della ricerca dopo il risultato
+ * @var vertical se le tessere possono essere messe in verticale, altrimenti si gioca su una sola fila
+ * @var tablebasePath file della tablebase dei finali (usata solo su una sola fila), NULL se non c'è
+ * @var moveOrdering se provare prima le mosse più promettenti (a parità di punteggio la partita trovata può cambiare)
+ * @var trailSolver se risolvere senza ricerca le mani senza tessere speciali giocate su una sola fila (trail_solver.h)
+ * @var subsetDP se risolvere con la programmazione dinamica le mani giocate su una sola fila (subset_dp.h)
+ * @var subsetDPMaxMb memoria massima della programmazione dinamica in MB: le mani che ne richiedono di più vengono cercate
+ * @var printMoves se stampare anche le mosse della partita, nell'ordine in cui vanno fatte
+ * @var iterative se usare la ricerca iterativa con lo stack sullo heap (iterative_ai.h) invece di quella ricorsiva:
+ * il risultato è lo stesso, le mosse vengono sempre fatte su un'unica situazione di gioco
+ * @var outputFormat come stampare il risultato: OUTPUT_ASCII, OUTPUT_RLE o OUTPUT_JSON (in modalità batch RLE e JSON
+ * scrivono il campo in codifica run-length invece che come disegno)
+ * @var mctsPlayouts playout della ricerca Monte Carlo (mcts.h) da usare al posto della ricerca completa, per le mani
+ * troppo grandi: la partita trovata potrebbe non essere la migliore. 0 per la ricerca completa
+ */
+typedef struct {
+    bool pruning;
+    bool inPlace;
+    int threads;
+    long budgetMs;
+    bool stats;
+    bool vertical;
+    const char *tablebasePath;
+    bool moveOrdering;
+    bool trailSolver;
+    bool subsetDP;
+    long subsetDPMaxMb;
+    bool printMoves;
+    bool iterative;
+    int outputFormat;
+    long mctsPlayouts;
+}aiOptions;
+
+/** Lista dei sottoproblemi della ricerca parallela (parallel_ai.h) */
+typedef struct aiTaskList aiTaskList;
+/** Migliore partita condivisa tra i thread della ricerca parallela (parallel_ai.h) */
+typedef struct sharedBestScore sharedBestScore;
+
+/**
+ * Tipo di dato che descrive dove finisce nel campo una tessera aggiunta
+ * @var row riga del primo lato della tessera (sinistro o in alto)
+ * @var col colonna del primo lato della tessera dopo lo spostamento del campo
+ * @var shift numero di colonne di cui il campo viene spostato a destra prima di aggiungere la tessera
+ * @var orientation orientamento della tessera
+ */
+typedef struct {
+    int row;
+    int col;
+    int shift;
+    char orientation;
+}tilePlacement;
+
+/**
+ * Tipo di dato per un'estremità di un tratto di tessere in una riga del campo
+ * @var row riga della cella
+ * @var col colonna della cella
+ * @var leftEnd se a sinistra della cella non ci sono tessere (si può attaccare una tessera a sinistra)
+ * @var rightEnd se a destra della cella non ci sono tessere (si può attaccare una tessera a destra)
+ */
+typedef struct {
+    int row;
+    int col;
+    bool leftEnd;
+    bool rightEnd;
+}attachPoint;
+
+/**
+ * Tipo di dato per una mossa da provare con la tessera da inserire
+ * @var row riga della tessera in gioco alla quale attaccare la tessera
+ * @var col colonna della tessera in gioco alla quale attaccare la tessera
+ * @var orientation orientamento della tessera da mettere
+ * @var isLinkedTo da che lato della tessera in gioco attaccare la tessera
+ * @var priority priorità della mossa, le mosse con priorità più alta vengono provate prima
+ */
+typedef struct {
+    int row;
+    int col;
+    char orientation;
+    char isLinkedTo;
+    int priority;
+}candidateMove;
+
+/**
+ * Tipo di dato per una mossa della partita, con i parametri da passare a makeMove
+ * @var tile tessera messa, già girata se serve (le speciali con i valori che hanno in mano)
+ * @var row riga della tessera in gioco alla quale viene attaccata
+ * @var col colonna della tessera in gioco alla quale viene attaccata, prima dello spostamento del campo
+ * @var orientation orientamento della tessera
+ * @var isLinkedTo da che lato della tessera in gioco viene attaccata, NOT_VALID_CHAR per la prima tessera
+ */
+typedef struct {
+    dominoTile tile;
+    int row;
+    int col;
+    char orientation;
+    char isLinkedTo;
+}placedTile;
+
+/**
+ * Tipo di dato per una partita salvata come sequenza di mosse invece che come campo da gioco
+ * @var moves mosse dalla prima tessera in poi
+ * @var numMoves numero di mosse
+ * @var score punteggio della partita, NO_SCORE se non c'è una partita
+ */
+typedef struct {
+    placedTile *moves;
+    int numMoves;
+    int score;
+}moveList;
+
+/**
+ * Tipo di dato per una situazione di gioco che la ricerca sta esplorando, condiviso dalla ricerca ricorsiva e da
+ * quella iterativa
+ * @var toBeat punteggio da superare, alzato dal pruning, dalla tablebase e dalla tabella delle trasposizioni
+ * @var best punteggio della migliore partita trovata, NO_SCORE se non ce ne sono
+ * @var key hash della situazione di gioco per la tabella delle trasposizioni
+ * @var symmetric se il campo è uguale alla sua immagine speculare (vengono provate solo le mosse a sinistra)
+ */
+typedef struct {
+    int toBeat;
+    int best;
+    unsigned long long key;
+    bool symmetric;
+}searchNode;
+
+/**
+ * Tipo di dato con i dati per annullare una mossa fatta direttamente sulla situazione di gioco
+ * @var rows righe prima della mossa
+ * @var cols colonne prima della mossa
+ * @var score punteggio prima della mossa
+ * @var increment se la mossa ha incrementato il campo con una [11|11]
+ * @var placement posizione della tessera aggiunta e spostamento del campo
+ * @var movedRowStarts se lo spostamento del campo ha spostato l'inizio delle righe invece delle celle (moveRight)
+ */
+typedef struct {
+    int rows;
+    int cols;
+    int score;
+    bool increment;
+    tilePlacement placement;
+    bool movedRowStarts;
+}undoRecord;
+
+/**
+ * Tipo di dato per i contatori del campo tenuti dalla ricerca mentre mette e toglie le tessere
+ * @var valueCounts numero di celle per ogni valore salvato (da 0 a 6), per calcolare il punteggio dopo una [11|11]
+ * senza scorrere il campo
+ * @var openEnds numero di estremità libere (lati di cella a cui si può attaccare una tessera in orizzontale) per
+ * ogni valore salvato
+ */
+typedef struct {
+    int valueCounts[7];
+    int openEnds[7];
+}boardCounts;
+
+/**
+ * Tipo di dato che contiene le strutture condivise da tutta la ricerca AI
+ * @var table tabella delle trasposizioni, NULL se non disponibile
+ * @var tablebase tablebase dei finali, NULL se non disponibile
+ * @var options opzioni della ricerca
+ * @var bestScore punteggio della migliore partita finita trovata finora
+ * @var nodes numero di situazioni di gioco esplorate
+ * @var shared migliore partita condivisa con gli altri thread, NULL se la ricerca è su un solo thread
+ * @var taskIndex indice del sottoproblema che il thread sta risolvendo
+ * @var tasks se non NULL la ricerca non risolve le situazioni di gioco con poche tessere in mano ma le salva come sottoproblemi
+ * @var deadline istante (in millisecondi, getTimeMs) in cui la ricerca deve fermarsi, 0 se non c'è limite di tempo
+ * @var timedOut se la ricerca è stata interrotta perché il tempo è finito
+ * @var incumbent migliore partita finita trovata finora, tenuta solo se c'è un limite di tempo
+ * @var counts contatori del campo su cui la ricerca fa le mosse: con --copy-boards vengono ripristinati dopo
+ * ogni copia esplorata
+ * @var numTiles tessere in mano all'inizio della partita, grandezza delle liste di mosse
+ * @var path mosse fatte dall'inizio della partita fino alla situazione di gioco esplorata
+ * @var lines per ogni numero di tessere in mano, migliore partita trovata dalla situazione di gioco esplorata con
+ * quelle tessere in mano: getBestGameAI restituisce solo il punteggio, le mosse sono qui
+ * @var bestMoves mosse della partita restituita da findBestGameAI
+ */
+typedef struct {
+    transpositionTable *table;
+    endgameTablebase *tablebase;
+    aiOptions options;
+    int bestScore;
+    long long nodes;
+    sharedBestScore *shared;
+    int taskIndex;
+    aiTaskList *tasks;
+    long long deadline;
+    bool timedOut;
+    moveList incumbent;
+    boardCounts counts;
+    int numTiles;
+    placedTile *path;
+    moveList *lines;
+    moveList bestMoves;
+}aiContext;
 
 // Functions prototypes
-void playAI(dominoTile[], int);
+aiOptions defaultAIOptions(void);
+void playAI(dominoTile[], int, aiOptions);
+aiContext createAIContext(aiOptions);
+void freeAIContext(aiContext*);
+gameSituation *findBestGameAI(dominoTile[], int, aiContext*);
 void printAI(gameSituation*);
-gameSituation *getBestGameAI(dominoTile*, int, gameSituation*);
-bool hasTileAdjacency(dominoTile, gameSituation);
-void move_left(dominoTile*, int, dominoTile);
-bool hasThisTileIn(dominoTile toFound, dominoTile *ar, int toCheckUntil);
+int getBestGameAI(tileHand*, gameSituation*, int, aiContext*);
+int searchBestGame(tileHand*, gameSituation*, int, aiContext*);
+bool beginSearchNode(tileHand*, gameSituation*, int, aiContext*, searchNode*);
+void endSearchNode(tileHand*, gameSituation*, aiContext*, searchNode*);
+void placeFirstTile(gameSituation*, boardCounts*, dominoTile);
+void removeFirstTile(gameSituation*, boardCounts*);
+bool fitTile(dominoTile*, gameSituation, int, int, char, char);
+bool endGameHand(tileHand*, gameSituation*, boardCounts*);
+int getOpenValuesMask(gameSituation*, boardCounts*);
+bool isLeftOpen(gameSituation*, int, int);
+bool isRightOpen(gameSituation*, int, int);
+void updateOpenEnds(gameSituation*, boardCounts*, int, int, int);
 gameSituation *copyGame(gameSituation, char, int);
-dominoTileSide **copyMatrixSides(gameSituation, int, int);
-void addDominoTile(gameSituation*, dominoTile, int, int, char, char);
+dominoTileSide **copyMatrixSides(gameSituation, int, int, int);
+void getGrownSize(gameSituation, char, int, int*, int*);
+tilePlacement getTilePlacement(int, int, char, char);
+bool addDominoTile(gameSituation*, boardCounts*, dominoTile, int, int, char, char);
+void makeMove(gameSituation*, boardCounts*, dominoTile, int, int, char, char, undoRecord*);
+void undoMove(gameSituation*, boardCounts*, undoRecord*);
+void applySpecialTile(dominoTile*, gameSituation*, boardCounts*, int, int, char, char);
+void placeSide(gameSituation*, boardCounts*, int, int, int, char);
+void removeSide(gameSituation*, boardCounts*, int, int);
 void freeGameSituation(gameSituation*);
-void copyDominoTileAr(dominoTile[], dominoTile*, int);
-gameSituation *bestTileInEachPosition(dominoTile*, int, gameSituation, char, char, int, int);
-gameSituation *bestGameTileIn(dominoTile*, int, gameSituation);
+int bestTileInEachPosition(tileHand*, dominoTile, gameSituation, char, char, int, int, int, aiContext*);
+int getAttachPoints(gameSituation, attachPoint*);
+int bestGameTileIn(tileHand*, dominoTile, gameSituation, int, bool, aiContext*);
+int getCandidateMoves(tileHand*, dominoTile, gameSituation*, bool, aiContext*, attachPoint*, int, candidateMove*);
+void addCandidateMove(candidateMove*, int*, int, int, char, char);
+void orderCandidateMoves(candidateMove*, int, tileHand*, dominoTile, gameSituation*);
+int getExposedValue(dominoTile, gameSituation*, candidateMove*);
+bool isMirrorInvariant(tileHand*, boardCounts*, aiOptions);
+bool isMirrorSymmetric(gameSituation);
+void getRowEnds(gameSituation, int*, int*);
+int scoreToBeat(int, int);
+int getBestScoreSoFar(aiContext*);
+void updateBestScore(aiContext*, int);
+long long getTimeMs(void);
+long long getTimeUs(void);
+long long getTimeNs(void);
+bool isTimeOver(aiContext*);
+void updateIncumbent(aiContext*, tileHand*, int);
+void allocMoveLists(aiContext*, int);
+void freeMoveLists(aiContext*);
+void recordMove(aiContext*, tileHand*, dominoTile, int, int, char, char);
+void saveLine(aiContext*, tileHand*, int);
+void keepLine(aiContext*, tileHand*);
+void copyMoveList(moveList*, moveList*);
+gameSituation *replayMoves(moveList*, int);
+void printMoveList(FILE*, moveList*);
+int maxReachableValue(int, int);
+int maxReachableScore(tileHand*, gameSituation);
 
 #endif // AI_H
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+/**
+ * @file batch.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la modalità batch: legge molte mani di tessere, una per riga, le risolve con l'AI
+ * e per ognuna stampa una riga JSON con il punteggio, il campo da gioco e il tempo impiegato.
+ * @date 17/10/2026
+ */
+
+#include "ai.h"
+#include "board_pool.h"
+#include "board_render.h"
+
+/** Numero massimo di tessere di una mano (le tessere lette vengono salvate in un array sulla pila) */
+#define MAX_BATCH_TILES 255
+/** Grandezza iniziale del buffer in cui viene letta una riga */
+#define BATCH_LINE_SIZE 256
+
+// Firme funzioni
+int runBatch(FILE *in, FILE *out, aiOptions options);
+char *readBatchLine(FILE *in, char **buffer, size_t *capacity);
+int parseHandLine(const char *line, dominoTile *tiles, const char **error);
+bool readTileValue(const char **line, int *value);
+bool isValidHandTile(dominoTile);
+void printBatchResult(FILE *out, long lineNumber, int numTiles, gameSituation*, long long timeUs, aiContext*);
+void renderMoveListJSON(textBuffer*, moveList*);
+void printBatchError(FILE *out, long lineNumber, const char *error);
+
+#endif // BATCH_H
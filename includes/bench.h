@@ -0,0 +1,61 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/**
+ * @file bench.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente i benchmark della modalità AI: risolve mani sempre uguali (generate da un seme fisso)
+ * al variare del numero di tessere, del numero di speciali e del tipo di campo, e per ogni mano stampa una riga
+ * JSON con tempo, situazioni di gioco al secondo, allocazioni e memoria massima usata.
+ * @date 17/10/2026
+ */
+
+#include "ai.h"
+#include "board_pool.h"
+
+#define BENCH_PLANE '2'
+#define BENCH_LINEAR 'L'
+#define BENCH_BOTH 'B'
+
+/**
+ * Tipo di dato che contiene le mani da provare nel benchmark
+ * @var minTiles numero minimo di tessere di una mano
+ * @var maxTiles numero massimo di tessere di una mano
+ * @var maxSpecials numero massimo di tessere speciali di una mano (sempre meno delle tessere)
+ * @var hands numero di mani per ogni combinazione
+ * @var seed seme da cui vengono generate le mani
+ * @var mode campi da provare: BENCH_PLANE (anche in verticale), BENCH_LINEAR (una sola fila) o BENCH_BOTH
+ * @var options opzioni della ricerca
+ */
+typedef struct {
+    int minTiles;
+    int maxTiles;
+    int maxSpecials;
+    int hands;
+    unsigned long long seed;
+    char mode;
+    aiOptions options;
+}benchConfig;
+
+/**
+ * Totali del benchmark
+ * @var hands mani risolte
+ * @var nodes situazioni di gioco esplorate
+ * @var timeUs microsecondi di ricerca
+ * @var allocations blocchi richiesti al pool
+ */
+typedef struct {
+    int hands;
+    long long nodes;
+    long long timeUs;
+    long long allocations;
+}benchTotals;
+
+// Firme funzioni
+benchConfig defaultBenchConfig(void);
+void runBenchmark(benchConfig, FILE *out);
+void benchHand(FILE *out, benchConfig*, int numTiles, int numSpecials, bool vertical, int hand, benchTotals*);
+unsigned long long getHandSeed(unsigned long long seed, int numTiles, int numSpecials, int hand);
+long getPeakMemoryKb(void);
+
+#endif // BENCH_H
@@ -0,0 +1,78 @@
+#ifndef BOARD_POOL_H
+#define BOARD_POOL_H
+
+/**
+ * @file board_pool.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente il pool di memoria per le situazioni di gioco: durante una ricerca AI le matrici del
+ * campo e le situazioni di gioco vengono prese da blocchi grandi e riutilizzate, e alla fine vengono liberate tutte insieme.
+ * @date 17/10/2026
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define POOL_CHUNK_SIZE (1 << 20)
+#define POOL_NUM_CLASSES 40
+#define POOL_MIN_CLASS 5
+
+// Ogni thread ha il suo pool
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define THREAD_LOCAL _Thread_local
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+/**
+ * Intestazione messa prima di ogni blocco di memoria restituito da allocBoardMemory
+ * @var sizeClass classe di grandezza del blocco (il blocco è grande 2^sizeClass byte, intestazione compresa)
+ * @var pooled se il blocco è stato preso dal pool (altrimenti è stato allocato con malloc)
+ */
+typedef struct {
+    size_t sizeClass;
+    size_t pooled;
+}poolBlockHeader;
+
+/**
+ * Blocco grande di memoria da cui vengono presi i blocchi del pool
+ * @var next blocco grande allocato prima di questo
+ * @var size byte utilizzabili del blocco grande
+ */
+typedef struct poolChunk {
+    struct poolChunk *next;
+    size_t size;
+}poolChunk;
+
+/**
+ * Tipo di dato per il pool di memoria
+ * @var freeLists per ogni classe di grandezza, lista dei blocchi liberati e riutilizzabili
+ * @var chunks lista dei blocchi grandi allocati
+ * @var spareChunks lista dei blocchi grandi tenuti da recycleBoardPool, da riutilizzare prima di allocarne di nuovi
+ * @var next prima posizione libera dell'ultimo blocco grande
+ * @var left byte liberi nell'ultimo blocco grande
+ * @var depth numero di beginBoardPool non ancora chiuse da endBoardPool
+ * @var allocations numero di blocchi richiesti da quando il pool è attivo
+ */
+typedef struct {
+    void *freeLists[POOL_NUM_CLASSES];
+    poolChunk *chunks;
+    poolChunk *spareChunks;
+    char *next;
+    size_t left;
+    int depth;
+    long long allocations;
+}boardPool;
+
+// Firme funzioni
+void beginBoardPool(void);
+void endBoardPool(void);
+void recycleBoardPool(void);
+int suspendBoardPool(void);
+void resumeBoardPool(int depth);
+bool isBoardPoolActive(void);
+long long getBoardPoolAllocations(void);
+char *allocPoolChunk(size_t bytes);
+void *allocBoardMemory(size_t bytes);
+void freeBoardMemory(void *memory);
+
+#endif // BOARD_POOL_H
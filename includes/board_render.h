@@ -0,0 +1,42 @@
+#ifndef BOARD_RENDER_H
+#define BOARD_RENDER_H
+
+/**
+ * @file board_render.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la stampa del campo da gioco: il testo viene costruito in un buffer e scritto con una
+ * sola chiamata, come disegno (ogni cella è larga 3 caratteri) oppure con una codifica compatta run-length.
+ * @date 17/10/2026
+ */
+
+#include "common_functions.h"
+#include <stdarg.h>
+#include <string.h>
+
+/** Grandezza iniziale di un buffer di testo */
+#define TEXT_BUFFER_SIZE 1024
+
+/**
+ * Tipo di dato per un buffer di testo che cresce quando serve, sempre terminato da '\0'
+ * @var text testo scritto finora
+ * @var length caratteri scritti
+ * @var capacity caratteri allocati
+ */
+typedef struct {
+    char *text;
+    size_t length;
+    size_t capacity;
+}textBuffer;
+
+// Firme funzioni
+textBuffer createTextBuffer(size_t capacity);
+void freeTextBuffer(textBuffer*);
+char *reserveText(textBuffer*, size_t);
+void appendText(textBuffer*, const char*);
+void appendFormat(textBuffer*, const char *format, ...);
+void writeTextBuffer(FILE*, textBuffer*);
+void renderBoardRow(textBuffer*, gameSituation*, int row, char topMark, char bottomMark);
+void renderBoard(textBuffer*, gameSituation*);
+void renderBoardRLE(textBuffer*, gameSituation*);
+
+#endif // BOARD_RENDER_H
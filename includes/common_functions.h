@@ -32,17 +32,20 @@ typedef struct{
     int right;
 }dominoTile;
 
+/** Cella vuota del campo da gioco */
+#define EMPTY_CELL 0
+/** Bit della cella con il valore salvato + 1 */
+#define CELL_VALUE_MASK 7
+/** Posizione dei bit della cella con il lato della tessera */
+#define CELL_SIDE_SHIFT 3
+
 /**
- * Tipo di dato per il singolo lato della tessera inserito nel campo da gioco
- * @var value valore
- * @var side specifica quale lato della tessera è: R(Right) or L(Left) || T(Top) or B(Bottom)
- * @var orientation specifica se la tessera è in verticale oppure orizzontale: H(Horizontal) || V(Vertical)
+ * Tipo di dato per il singolo lato della tessera inserito nel campo da gioco, impacchettato in un byte: nei 3 bit
+ * bassi il valore salvato + 1 (0 per la cella vuota), nei 2 successivi il lato della tessera, R(Right) or L(Left) ||
+ * T(Top) or B(Bottom). L'orientamento dipende dal lato: L e R sono orizzontali, T e B verticali.
+ * Si legge con getCellValue, getCellSide e getCellOrientation e si scrive con packCell.
  */
-typedef struct{
-    int value;
-    char side;
-    char orientation;
-}dominoTileSide;
+typedef unsigned char dominoTileSide;
 
 /**
  * Tipo di dato che contiene tutte le info sulla situazione di gioco
@@ -51,24 +54,78 @@ typedef struct{
  * @var score punteggio
  * @var rows righe del campo da gioco
  * @var cols colonne del campo da gioco
+ * @var increments numero di [11|11] giocate (modulo 6) non ancora applicate ai valori salvati nelle celle:
+ * il valore di una cella si legge con getSideValue
+ * @var leftCols colonne allocate (vuote) a sinistra della colonna 0 in ogni riga: quando il campo cresce a sinistra
+ * moveRight sposta l'inizio delle righe su di esse invece di spostare le celle
+ * @var maxLeftCols colonne allocate a sinistra della colonna 0 quando il campo è stato creato
+ * @var allocatedRows righe allocate del campo, a cui moveRight e moveLeft spostano l'inizio
  */
 typedef struct {
     dominoTileSide **inGameDominoTiles;
     int score;
     int rows;
     int cols;
+    int increments;
+    int leftCols;
+    int maxLeftCols;
+    int allocatedRows;
 }gameSituation;
 
 
+/**
+ * Restituisce il valore salvato in una cella del campo (senza le [11|11] non ancora applicate, vedi getSideValue)
+ * @param cell cella del campo
+ * @return valore salvato, NOT_VALID_INT se la cella è vuota
+ */
+inline int getCellValue(dominoTileSide cell) {
+    return (cell & CELL_VALUE_MASK) - 1;
+}
+
+/**
+ * Restituisce il lato della tessera in una cella del campo
+ * @param cell cella del campo
+ * @return LEFT, RIGHT, TOP o BOTTOM, NOT_VALID_CHAR se la cella è vuota
+ */
+inline char getCellSide(dominoTileSide cell) {
+    return cell == EMPTY_CELL ? NOT_VALID_CHAR : "LRTB"[cell >> CELL_SIDE_SHIFT];
+}
+
+/**
+ * Restituisce l'orientamento della tessera in una cella del campo
+ * @param cell cella del campo
+ * @return HORIZONTAL o VERTICAL, NOT_VALID_CHAR se la cella è vuota
+ */
+inline char getCellOrientation(dominoTileSide cell) {
+    return cell == EMPTY_CELL ? NOT_VALID_CHAR : (cell >> CELL_SIDE_SHIFT) < 2 ? HORIZONTAL : VERTICAL;
+}
+
+/**
+ * Impacchetta un lato di tessera in una cella del campo
+ * @param value valore da salvare (da 0 a 6)
+ * @param side lato della tessera: LEFT, RIGHT, TOP o BOTTOM
+ * @return cella del campo
+ */
+inline dominoTileSide packCell(int value, char side) {
+    int sideCode = side == LEFT ? 0 : side == RIGHT ? 1 : side == TOP ? 2 : 3;
+    return (dominoTileSide) ((value + 1) | sideCode << CELL_SIDE_SHIFT);
+}
+
 // Firme funzioni
 void generateTiles(int numTotalTiles, int numSpecials, dominoTile[]);
+void generateTilesSeeded(int numTotalTiles, int numSpecials, dominoTile[], unsigned long long *seed);
+int nextRandom(unsigned long long *seed, int bound);
 void printTiles(int numTiles, dominoTile[]);
-void moveRight(gameSituation*, int);
-dominoTileSide **createInGameDominoTiles(int, int);
-void initializeMatrix(dominoTileSide**, int, int);
+bool moveRight(gameSituation*, int);
+void moveLeft(gameSituation*, int, bool);
+dominoTileSide **allocInGameDominoTiles(int, int, int);
+dominoTileSide **createInGameDominoTiles(int, int, int);
 void freeInGameDominoTiles (dominoTileSide **dominoTilesInGame, int rows);
 void rotateDominoTile(dominoTile*);
 void fixSpecialTiles(dominoTile*, gameSituation*, int, int, char, char);
+int getSideValue(gameSituation*, int, int);
+int getActualValue(gameSituation*, int);
+int getStoredValue(gameSituation*, int);
 bool isValidMove(dominoTile, gameSituation, int, int, char, char);
 bool endGame(int numTotalTiles, dominoTile  [], gameSituation game);
 
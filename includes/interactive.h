@@ -9,12 +9,14 @@
  */
 
 #include "common_functions.h"
+#include "board_render.h"
 #include <ctype.h>
+#include <string.h>
 
 void playInteractive(int, dominoTile[]);
 int chooseTile(int);
 void insertTile(gameSituation*, dominoTile*, dominoTile, int, int, char, int*);
 void printTilesInGame(gameSituation);
-bool hasSpecials(dominoTile[], int);
+void reserveBoard(gameSituation*, int*, int, int);
 
 #endif // INTERACTIVE_H
@@ -0,0 +1,84 @@
+#ifndef ITERATIVE_AI_H
+#define ITERATIVE_AI_H
+
+/**
+ * @file iterative_ai.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la ricerca AI iterativa: le situazioni di gioco che la ricerca ricorsiva terrebbe sullo
+ * stack delle chiamate sono in uno stack allocato sullo heap, quindi la profondità non dipende dallo stack del thread
+ * e la ricerca può essere fermata dopo un certo numero di situazioni di gioco e ripresa, o annullata. Il risultato è
+ * lo stesso della ricerca ricorsiva (getBestGameAI), che usa le stesse funzioni per ogni situazione di gioco.
+ * @date 17/10/2026
+ */
+
+#include "ai.h"
+
+/** La situazione di gioco deve ancora essere controllata con beginSearchNode */
+#define FRAME_ENTER 0
+/** Si sta cercando il prossimo tipo di tessera da provare */
+#define FRAME_TYPES 1
+/** Si stanno provando le mosse della tessera attuale */
+#define FRAME_MOVES 2
+/** La prima tessera della partita è in gioco e si sta esplorando la situazione di gioco successiva */
+#define FRAME_FIRST_CHILD 3
+/** Una mossa è fatta e si sta esplorando la situazione di gioco successiva */
+#define FRAME_MOVE_CHILD 4
+
+/**
+ * Tipo di dato per una situazione di gioco nello stack della ricerca iterativa: contiene le variabili che la ricerca
+ * ricorsiva tiene in getBestGameAI, bestGameTileIn e bestTileInEachPosition
+ * @var node dati della situazione di gioco
+ * @var state punto della ricerca in cui si trova la situazione di gioco (FRAME_ENTER, FRAME_TYPES, ...)
+ * @var typeIndex prossimo tipo di tessera da provare, nell'ordine della ricerca
+ * @var type tipo della tessera che si sta provando
+ * @var tile tessera che si sta provando
+ * @var moves mosse da provare con la tessera
+ * @var numMoves numero di mosse da provare
+ * @var moveIndex prossima mossa da provare
+ * @var undo dati per annullare la mossa fatta
+ */
+typedef struct {
+    searchNode node;
+    char state;
+    int typeIndex;
+    int type;
+    dominoTile tile;
+    candidateMove *moves;
+    int numMoves;
+    int moveIndex;
+    undoRecord undo;
+}searchFrame;
+
+/**
+ * Tipo di dato per una ricerca iterativa. Mentre la ricerca è ferma la mano e la situazione di gioco restano con le
+ * mosse fatte fino alla situazione di gioco da cui ripartire, e non vanno modificate.
+ * @var hand tessere in mano, modificata durante la ricerca e ripristinata alla fine
+ * @var game situazione di gioco, con spazio per tutte le tessere: le mosse vengono fatte e annullate su di essa
+ * @var context strutture condivise dalla ricerca
+ * @var frames stack delle situazioni di gioco, una per ogni tessera messa più quella iniziale
+ * @var depth indice della situazione di gioco in cima allo stack, -1 se la ricerca è finita
+ * @var points estremità dei tratti di tessere in gioco, per preparare le mosse
+ * @var maxSides numero massimo di lati di tessera in gioco
+ * @var result punteggio della migliore partita (come getBestGameAI), valido quando la ricerca è finita
+ */
+typedef struct {
+    tileHand *hand;
+    gameSituation *game;
+    aiContext *context;
+    searchFrame *frames;
+    int depth;
+    attachPoint *points;
+    int maxSides;
+    int result;
+}iterativeSearch;
+
+// Firme funzioni
+int getBestGameIterative(tileHand*, gameSituation*, int, aiContext*);
+iterativeSearch createIterativeSearch(tileHand*, gameSituation*, int, aiContext*);
+bool runIterativeSearch(iterativeSearch*, long long);
+void freeIterativeSearch(iterativeSearch*);
+void pushSearchFrame(iterativeSearch*, int);
+void popSearchFrame(iterativeSearch*, int);
+bool nextSearchMove(iterativeSearch*, searchFrame*);
+
+#endif // ITERATIVE_AI_H
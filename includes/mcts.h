@@ -0,0 +1,133 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+/**
+ * @file mcts.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la ricerca Monte Carlo (MCTS) per le mani troppo grandi per la ricerca completa: ogni
+ * playout scende nell'albero delle mosse già esplorate scegliendo con UCT, lo allarga di un livello e finisce la
+ * partita con mosse casuali. Le mosse valide sono le stesse della ricerca completa (getCandidateMoves, fitTile) e
+ * vengono fatte e annullate su un'unica situazione di gioco (makeMove, undoMove). Con più thread ogni thread fa
+ * crescere il suo albero e vince la migliore partita trovata. La partita non è dimostrata la migliore.
+ * @date 17/10/2026
+ */
+
+#include "ai.h"
+#include <math.h>
+#include <pthread.h>
+
+/** Costante di esplorazione di UCT: più è grande, più i playout provano le mosse poco visitate */
+#define MCTS_EXPLORATION 0.5
+/** Seme dei numeri casuali dei playout: con lo stesso numero di playout il risultato non cambia */
+#define MCTS_SEED 0x2545F4914F6CDD1DULL
+/** Ogni quanti playout controllare se il tempo a disposizione è finito */
+#define MCTS_TIME_CHECK_INTERVAL 16
+/** Nodi allocati all'inizio per l'albero di ogni thread */
+#define MCTS_INITIAL_NODES 4096
+/** Nodi massimi dell'albero di ogni thread: quando è pieno i playout continuano senza allargarlo */
+#define MCTS_MAX_NODES (1 << 21)
+
+/**
+ * Tipo di dato per una mossa della ricerca Monte Carlo
+ * @var move tessera (già girata se serve) e dove viene attaccata, come nelle mosse della ricerca completa
+ * @var type tipo della tessera
+ */
+typedef struct {
+    placedTile move;
+    int type;
+}mctsMove;
+
+/**
+ * Tipo di dato per un nodo dell'albero: la situazione di gioco raggiunta dalla radice con le mosse dei nodi padre
+ * @var move mossa che porta al nodo dal padre
+ * @var firstChild indice del primo figlio, NOT_VALID_INT se il nodo non è ancora stato espanso
+ * @var numChildren numero di figli, uno per ogni mossa valida (0 se la partita è finita)
+ * @var visits playout passati dal nodo
+ * @var totalScore somma dei punteggi finali dei playout passati dal nodo
+ */
+typedef struct {
+    mctsMove move;
+    int firstChild;
+    int numChildren;
+    int visits;
+    double totalScore;
+}mctsNode;
+
+/**
+ * Tipo di dato per l'albero di un thread, con la situazione di gioco su cui vengono fatte le mosse
+ * @var context strutture della ricerca: servono le opzioni, i contatori del campo e il contatore delle situazioni di
+ * gioco esplorate
+ * @var hand tessere in mano
+ * @var game situazione di gioco, con spazio per tutte le tessere
+ * @var nodes nodi dell'albero, la radice è il nodo 0
+ * @var numNodes nodi usati
+ * @var capacity nodi allocati
+ * @var points estremità dei tratti di tessere in gioco, per preparare le mosse
+ * @var candidates mosse da provare con una tessera
+ * @var moves mosse valide della situazione di gioco (getMCTSMoves)
+ * @var path mosse fatte dalla situazione iniziale, una per tessera
+ * @var undo dati per annullare le mosse fatte
+ * @var depth mosse fatte
+ * @var visited nodi dell'albero attraversati dal playout, dalla radice
+ * @var numVisited nodi attraversati
+ * @var seed stato dei numeri casuali
+ * @var best migliore partita trovata
+ * @var playouts playout fatti
+ */
+typedef struct {
+    aiContext context;
+    tileHand hand;
+    gameSituation game;
+    mctsNode *nodes;
+    int numNodes;
+    int capacity;
+    attachPoint *points;
+    candidateMove *candidates;
+    mctsMove *moves;
+    mctsMove *path;
+    undoRecord *undo;
+    int depth;
+    int *visited;
+    int numVisited;
+    unsigned long long seed;
+    moveList best;
+    long long playouts;
+}mctsTree;
+
+/**
+ * Tipo di dato per i dati di un thread della ricerca Monte Carlo
+ * @var tiles tessere in mano
+ * @var numTiles numero di tessere in mano
+ * @var options opzioni della ricerca
+ * @var seed seme dei numeri casuali del thread
+ * @var playouts playout da fare
+ * @var deadline istante (getTimeMs) in cui fermarsi, 0 se non c'è limite di tempo
+ * @var best migliore partita trovata dal thread
+ * @var nodes situazioni di gioco esplorate dal thread
+ * @var stats contatori della ricerca del thread
+ */
+typedef struct {
+    dominoTile *tiles;
+    int numTiles;
+    aiOptions options;
+    unsigned long long seed;
+    long long playouts;
+    long long deadline;
+    moveList best;
+    long long nodes;
+    searchStats stats;
+}mctsWorkerData;
+
+// Firme funzioni
+gameSituation *getBestGameMCTS(dominoTile*, int, aiContext*);
+void *mctsWorker(void*);
+mctsTree createMCTSTree(dominoTile*, int, aiOptions, unsigned long long);
+void freeMCTSTree(mctsTree*);
+void runMCTSPlayout(mctsTree*);
+int selectMCTSChild(mctsTree*, int);
+bool expandMCTSNode(mctsTree*, int);
+int getMCTSMoves(mctsTree*);
+void applyMCTSMove(mctsTree*, mctsMove*);
+void undoMCTSMove(mctsTree*);
+
+#endif // MCTS_H
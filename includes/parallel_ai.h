@@ -0,0 +1,131 @@
+#ifndef PARALLEL_AI_H
+#define PARALLEL_AI_H
+
+/**
+ * @file parallel_ai.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la ricerca AI su più thread: i sottoproblemi dopo le prime mosse vengono divisi tra
+ * i thread, che si rubano il lavoro a vicenda e condividono il punteggio della migliore partita trovata.
+ * @date 17/10/2026
+ */
+
+#include "ai.h"
+#include <pthread.h>
+
+#define MIN_TASKS_PER_THREAD 4
+#define MAX_SPLIT_DEPTH 3
+#define MIN_TABLE_SIZE_LOG2 16
+
+/**
+ * Tipo di dato per un sottoproblema della ricerca parallela
+ * @var game situazione di gioco da cui partire
+ * @var counts contatori del campo della situazione di gioco
+ * @var hand tessere in mano
+ * @var moves mosse fatte per arrivare alla situazione di gioco
+ */
+typedef struct {
+    gameSituation *game;
+    boardCounts counts;
+    tileHand hand;
+    moveList moves;
+}aiTask;
+
+/**
+ * Lista dei sottoproblemi raccolti dalla ricerca, nell'ordine in cui la ricerca su un solo thread li esplorerebbe
+ * @var tasks array dei sottoproblemi
+ * @var numTasks numero di sottoproblemi
+ * @var capacity grandezza dell'array
+ * @var splitAt numero di tessere in mano sotto il quale la ricerca si ferma e salva il sottoproblema
+ */
+struct aiTaskList {
+    aiTask *tasks;
+    int numTasks;
+    int capacity;
+    int splitAt;
+};
+
+/**
+ * Migliore partita trovata dai thread: punteggio e indice del sottoproblema (a parità di punteggio vince quello
+ * con indice più basso, come nella ricerca su un solo thread), impacchettati in un solo valore aggiornato atomicamente
+ * @var packed punteggio (+ 2^30) nei 32 bit alti, complemento dell'indice del sottoproblema nei 32 bit bassi
+ */
+struct sharedBestScore {
+    long long packed;
+};
+
+/**
+ * Coda dei sottoproblemi di un thread: il thread prende dall'inizio, gli altri rubano dalla fine
+ * @var taskIndexes indici dei sottoproblemi
+ * @var head primo sottoproblema ancora da fare
+ * @var tail posizione dopo l'ultimo sottoproblema ancora da fare
+ * @var lock mutex della coda
+ */
+typedef struct {
+    int *taskIndexes;
+    int head;
+    int tail;
+    pthread_mutex_t lock;
+}workerQueue;
+
+/**
+ * Dati condivisi dalla ricerca parallela
+ * @var taskList sottoproblemi da risolvere
+ * @var queues code dei thread
+ * @var numWorkers numero di thread
+ * @var best migliore partita trovata
+ * @var options opzioni della ricerca
+ * @var allocatedRows righe delle matrici su cui i thread fanno le mosse
+ * @var allocatedCols colonne delle matrici su cui i thread fanno le mosse
+ * @var tableSizeLog2 grandezza della tabella delle trasposizioni di ogni thread
+ * @var deadline istante in cui i thread devono fermarsi, 0 se non c'è limite di tempo
+ * @var tablebase tablebase dei finali condivisa dai thread (in sola lettura), NULL se non c'è
+ * @var numTiles tessere in mano all'inizio della partita, grandezza delle liste di mosse
+ */
+typedef struct {
+    aiTaskList *taskList;
+    workerQueue *queues;
+    int numWorkers;
+    sharedBestScore best;
+    aiOptions options;
+    int allocatedRows;
+    int allocatedCols;
+    int tableSizeLog2;
+    long long deadline;
+    endgameTablebase *tablebase;
+    int numTiles;
+}parallelSearch;
+
+/**
+ * Dati di un thread della ricerca parallela
+ * @var search dati condivisi
+ * @var id indice del thread
+ * @var best mosse della migliore partita trovata dal thread, NO_SCORE come punteggio se non ce ne sono
+ * @var bestIndex indice del sottoproblema della migliore situazione di gioco
+ * @var nodes situazioni di gioco esplorate dal thread
+ * @var timedOut se il thread si è fermato perché il tempo è finito
+ * @var stats contatori della ricerca del thread
+ */
+typedef struct {
+    parallelSearch *search;
+    int id;
+    moveList best;
+    int bestIndex;
+    long long nodes;
+    bool timedOut;
+    searchStats stats;
+}workerData;
+
+// Firme funzioni
+int getBestGameParallel(tileHand*, gameSituation*, aiContext*);
+void collectTasks(tileHand*, gameSituation*, aiContext*, aiTaskList*);
+void addTask(aiTaskList*, tileHand*, gameSituation, boardCounts*, placedTile*, int);
+void freeTaskList(aiTaskList*);
+int nextTask(parallelSearch*, int);
+void *searchWorker(void*);
+void keepBetterResult(workerData*, moveList*, int);
+bool isBetterResult(int, int, int, int);
+long long packBestScore(int, int);
+int readSharedBestScore(sharedBestScore*, int);
+void updateSharedBestScore(sharedBestScore*, int, int);
+
+#endif // PARALLEL_AI_H
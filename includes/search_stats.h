@@ -0,0 +1,54 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+/**
+ * @file search_stats.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente i contatori della ricerca AI: ogni thread incrementa i suoi (senza sincronizzazione,
+ * quindi restano sempre attivi), alla fine della ricerca vengono sommati e stampati con --stats.
+ * @date 17/10/2026
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "board_pool.h"
+#include "board_render.h"
+
+/** Numero di profondità contate separatamente, le situazioni con più tessere in mano finiscono nell'ultima */
+#define MAX_STATS_DEPTH 64
+
+/**
+ * Tipo di dato per i contatori della ricerca
+ * @var nodesByTilesLeft situazioni di gioco esplorate per numero di tessere ancora in mano
+ * @var copyGameCalls chiamate a copyGame
+ * @var bytesCopied byte delle matrici del campo copiate
+ * @var validMoveCalls mosse controllate dalla ricerca con isValidMove
+ * @var endGameScans controlli di fine partita che hanno dovuto confrontare le estremità libere con le tessere in mano
+ * @var tablebaseHits situazioni di gioco trovate nella tablebase dei finali
+ * @var specialTileCalls tessere speciali sistemate (fixSpecialTiles o [11|11] applicata senza toccare il campo)
+ * @var specialTileNs nanosecondi spesi a sistemare le tessere speciali, misurati solo se timeSpecials
+ * @var timeSpecials se misurare il tempo speso a sistemare le tessere speciali
+ */
+typedef struct {
+    long long nodesByTilesLeft[MAX_STATS_DEPTH];
+    long long copyGameCalls;
+    long long bytesCopied;
+    long long validMoveCalls;
+    long long endGameScans;
+    long long tablebaseHits;
+    long long specialTileCalls;
+    long long specialTileNs;
+    bool timeSpecials;
+}searchStats;
+
+/** Contatori del thread */
+extern THREAD_LOCAL searchStats threadStats;
+
+// Firme funzioni
+void resetSearchStats(bool timeSpecials);
+void addSearchStats(searchStats *total, searchStats *part);
+void countNode(int tilesLeft);
+void printSearchStats(FILE *out, searchStats*, int numTiles);
+void renderSearchStatsJSON(textBuffer*, searchStats*, int numTiles);
+
+#endif // SEARCH_STATS_H
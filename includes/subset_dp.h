@@ -0,0 +1,68 @@
+#ifndef SUBSET_DP_H
+#define SUBSET_DP_H
+
+/**
+ * @file subset_dp.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente il risolutore esatto a programmazione dinamica per le mani giocate su una sola fila,
+ * anche con tessere speciali: il miglior punteggio aggiuntivo dipende solo dalle tessere già usate e dai valori alle
+ * estremità della fila, quindi ogni situazione viene risolta una volta sola. La memoria serve tutta all'inizio e
+ * viene stimata prima, così le mani troppo grandi vengono rifiutate.
+ * @date 17/10/2026
+ */
+
+#include "ai.h"
+
+/** Memoria massima di default della programmazione dinamica, in MB */
+#define DEFAULT_SUBSET_DP_MB 1024
+/** Valore di una voce non ancora calcolata */
+#define SUBSET_DP_UNKNOWN 0xFFFF
+/** Stati delle estremità quando si deve ricordare anche la tessera alle estremità (7^4) */
+#define SUBSET_DP_FULL_ENDS 2401
+/** Stati delle estremità quando bastano i due valori esterni (7^2) */
+#define SUBSET_DP_OUTER_ENDS 49
+
+/**
+ * Tipo di dato per i valori alle estremità della fila (da 0 a 6)
+ * @var left valore della cella più a sinistra
+ * @var leftInner valore dell'altro lato della tessera più a sinistra
+ * @var right valore della cella più a destra
+ * @var rightInner valore dell'altro lato della tessera più a destra
+ */
+typedef struct {
+    int left;
+    int leftInner;
+    int right;
+    int rightInner;
+}rowEnds;
+
+/**
+ * Tipo di dato per la tabella della programmazione dinamica. Le tessere usate sono numerate per tipo (in base
+ * numero di tessere del tipo + 1); le [12|21] sono contate a parte perché finché ce n'è una in mano servono anche
+ * i valori interni delle estremità (la [12|21] copia la tessera a cui viene attaccata), dopo bastano quelli esterni.
+ * @var strides per ogni tipo, quanto aumenta l'indice delle tessere usate usandone una (0 per le [12|21])
+ * @var restMasks numero di combinazioni delle tessere usate diverse dalle [12|21]
+ * @var mirrors numero di [12|21] nella mano
+ * @var numEntries numero di voci della tabella
+ * @var values miglior punteggio aggiuntivo di ogni voce, SUBSET_DP_UNKNOWN se non ancora calcolato
+ * @var states voci calcolate
+ */
+typedef struct {
+    long long strides[NUM_TILE_TYPES];
+    long long restMasks;
+    int mirrors;
+    long long numEntries;
+    unsigned short *values;
+    long long states;
+}subsetDP;
+
+// Firme funzioni
+long long estimateSubsetDPBytes(dominoTile*, int);
+gameSituation *getBestSubsetDPGame(dominoTile*, int, long long*, moveList*);
+subsetDP createSubsetDP(tileHand*);
+int solveSubsetDP(subsetDP*, tileHand*, long long, rowEnds);
+long long getSubsetDPEntry(subsetDP*, tileHand*, long long, rowEnds);
+bool getSubsetDPMove(int, char, rowEnds, int, rowEnds*, int*);
+int rotateValue(int, int);
+
+#endif // SUBSET_DP_H
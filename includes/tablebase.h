@@ -0,0 +1,63 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+/**
+ * @file tablebase.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la tablebase dei finali: per ogni mano di poche tessere normali e ogni coppia di valori
+ * alle estremità della fila, il miglior punteggio aggiuntivo giocando su una sola fila. Viene calcolata una volta
+ * da tools/gen_tablebase.c, salvata in un file binario e letta con mmap (le pagine vengono caricate solo quando servono).
+ * @date 17/10/2026
+ */
+
+#include "tile_hand.h"
+
+/** Numero di tessere in mano di default della tablebase */
+#define DEFAULT_TABLEBASE_TILES 4
+/** Numero massimo di tessere in mano della tablebase */
+#define MAX_TABLEBASE_TILES 6
+/** Numero di valori che può avere un'estremità della fila (da 0 a 6) */
+#define TABLEBASE_END_VALUES 7
+/** Identificativo all'inizio del file */
+#define TABLEBASE_MAGIC "DOMTB1"
+
+/**
+ * Intestazione del file della tablebase, seguita da numEntries byte (ordine dei byte della macchina che l'ha generata)
+ * @var magic TABLEBASE_MAGIC
+ * @var maxTiles numero massimo di tessere in mano
+ * @var endValues numero di valori di ogni estremità (TABLEBASE_END_VALUES)
+ * @var numEntries numero di voci
+ */
+typedef struct {
+    char magic[8];
+    unsigned int maxTiles;
+    unsigned int endValues;
+    unsigned long long numEntries;
+}tablebaseHeader;
+
+/**
+ * Tipo di dato per la tablebase caricata
+ * @var mapping memoria mappata del file (intestazione compresa)
+ * @var size byte mappati
+ * @var entries miglior punteggio aggiuntivo di ogni voce (tablebaseIndex)
+ * @var maxTiles numero massimo di tessere in mano
+ */
+typedef struct {
+    void *mapping;
+    size_t size;
+    const unsigned char *entries;
+    int maxTiles;
+}endgameTablebase;
+
+// Firme funzioni
+endgameTablebase *openTablebase(const char *path);
+void closeTablebase(endgameTablebase*);
+bool probeTablebase(const endgameTablebase*, tileHand*, int leftValue, int rightValue, int *value);
+long long tablebaseIndex(const int *types, int numTiles, int leftValue, int rightValue);
+long long countMultisets(int numTiles);
+long long binomial(int n, int k);
+bool nextMultiset(int *types, int numTiles);
+int solveTablebaseEntry(const unsigned char *entries, const int *types, int numTiles, int leftValue, int rightValue);
+bool writeTablebase(const char *path, int maxTiles);
+
+#endif // TABLEBASE_H
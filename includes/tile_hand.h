@@ -0,0 +1,42 @@
+#ifndef TILE_HAND_H
+#define TILE_HAND_H
+
+/**
+ * @file tile_hand.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la mano di tessere usata dalla modalità AI: per ogni tipo di tessera
+ * viene tenuto solo quante ce ne sono, così le tessere uguali vengono provate una volta sola.
+ * @date 17/10/2026
+ */
+
+#include "common_functions.h"
+
+#define NUM_TILE_TYPES 24
+#define NUM_NORMAL_TYPES 21
+#define ZERO_TYPE 21
+#define INCREMENT_TYPE 22
+#define MIRROR_TYPE 23
+
+/**
+ * Tipo di dato per le tessere in mano
+ * @var counts numero di tessere in mano per ogni tipo (getTileType)
+ * @var numTiles numero totale di tessere in mano
+ * @var pipCounts numero di tessere normali in mano che hanno ogni valore (da 1 a 6) su almeno un lato
+ */
+typedef struct {
+    int counts[NUM_TILE_TYPES];
+    int numTiles;
+    int pipCounts[7];
+}tileHand;
+
+// Firme funzioni
+tileHand createTileHand(dominoTile*, int);
+int getTileType(dominoTile);
+dominoTile getTileOfType(int);
+int getOrderedType(int);
+bool isSpecialType(int);
+void removeTileFromHand(tileHand*, int);
+void addTileToHand(tileHand*, int);
+int getHandPipMask(tileHand*);
+
+#endif // TILE_HAND_H
@@ -0,0 +1,26 @@
+#ifndef TRAIL_SOLVER_H
+#define TRAIL_SOLVER_H
+
+/**
+ * @file trail_solver.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente il risolutore esatto delle mani senza tessere speciali giocate su una sola fila.
+ * La fila è un cammino nel multigrafo che ha i valori da 1 a 6 come nodi e le tessere come archi (le doppie sono
+ * cappi), che usa ogni arco al massimo una volta: la migliore partita è il cammino di peso massimo, che si trova
+ * scegliendo quali tessere usare e mettendole in fila con l'algoritmo di Hierholzer, senza la ricerca della modalità AI.
+ * @date 17/10/2026
+ */
+
+#include "ai.h"
+
+/** Numero di valori delle tessere normali più uno: gli indici vanno da 1 a 6 */
+#define TRAIL_VALUES 7
+
+// Firme funzioni
+bool canSolveAsTrail(dominoTile*, int, bool);
+gameSituation *getBestTrailGame(dominoTile*, int, moveList*);
+int chooseTrailTiles(int counts[TRAIL_VALUES][TRAIL_VALUES], int chosen[TRAIL_VALUES][TRAIL_VALUES]);
+bool isTrail(int chosen[TRAIL_VALUES][TRAIL_VALUES], int values);
+int buildTrail(int chosen[TRAIL_VALUES][TRAIL_VALUES], int numTiles, int *trail);
+
+#endif // TRAIL_SOLVER_H
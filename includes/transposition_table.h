@@ -0,0 +1,53 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+/**
+ * @file transposition_table.h
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la tabella delle trasposizioni usata dalla modalità AI per non
+ * risolvere più volte la stessa situazione di gioco.
+ * @date 17/10/2026
+ */
+
+#include "tile_hand.h"
+
+#define EXACT_SCORE 'E'
+#define UPPER_SCORE 'U'
+#define DEFAULT_TABLE_SIZE_LOG2 20
+
+/**
+ * Tipo di dato per una singola voce della tabella delle trasposizioni
+ * @var key hash della situazione di gioco (tessere in mano + campo da gioco)
+ * @var value miglior punteggio aggiuntivo ottenibile dalla situazione di gioco
+ * @var bound EXACT_SCORE se value è il valore esatto, UPPER_SCORE se è solo un limite superiore
+ * @var depth numero di tessere in mano nella situazione salvata, usato per scegliere cosa sovrascrivere
+ */
+typedef struct {
+    unsigned long long key;
+    int value;
+    char bound;
+    char depth;
+}transpositionEntry;
+
+/**
+ * Tipo di dato per la tabella delle trasposizioni: ogni bucket ha due voci, la prima viene
+ * sostituita solo da situazioni con più tessere in mano, la seconda viene sempre sovrascritta.
+ * @var entries array di voci (2 per bucket)
+ * @var mask maschera per ricavare il bucket dall'hash
+ */
+typedef struct {
+    transpositionEntry *entries;
+    unsigned long long mask;
+}transpositionTable;
+
+// Firme funzioni
+transpositionTable *createTranspositionTable(int sizeLog2);
+void freeTranspositionTable(transpositionTable*);
+bool probeTranspositionTable(transpositionTable*, unsigned long long key, int *value, char *bound);
+void storeTranspositionTable(transpositionTable*, unsigned long long key, int value, char bound, int depth);
+unsigned long long zobristKey(unsigned long long index);
+unsigned long long hashTileHand(tileHand*);
+unsigned long long hashGameState(tileHand*, gameSituation);
+unsigned long long hashLinearGameState(tileHand*, gameSituation);
+
+#endif // TRANSPOSITION_TABLE_H
@@ -5,229 +5,1070 @@
  * @date 06/02/2024
  */
 
+// clock_gettime
+#define _POSIX_C_SOURCE 200112L
+
 // Includes
 #include "ai.h"
+#include "parallel_ai.h"
+#include "trail_solver.h"
+#include "subset_dp.h"
+#include "iterative_ai.h"
+#include "board_render.h"
+#include "batch.h"
+#include "mcts.h"
+
+/**
+ * Restituisce le opzioni di default della modalità AI
+ * @returns opzioni con il pruning attivo, mosse fatte e annullate su un'unica situazione di gioco, un solo thread,
+ * senza limite di tempo e senza statistiche
+ */
+aiOptions defaultAIOptions(void) {
+    aiOptions options = {
+            .pruning = true,
+            .inPlace = true,
+            .threads = 1,
+            .budgetMs = 0,
+            .stats = false,
+            .vertical = true,
+            .tablebasePath = NULL,
+            .moveOrdering = false,
+            .trailSolver = true,
+            .subsetDP = false,
+            .subsetDPMaxMb = DEFAULT_SUBSET_DP_MB,
+            .printMoves = false,
+            .iterative = false,
+            .outputFormat = OUTPUT_ASCII,
+            .mctsPlayouts = 0
+    };
+    return options;
+}
 
 /**
  * Funzione principale che gestisce la modalità AI: in particolare inizializza la funzione ricorsiva
  * e alla fine stampa il suo risultato.
  * @param tilesOnHand array di tessere generate
  * @param numTilesOnHand numero di tessere generate
+ * @param options opzioni della ricerca
  */
-void playAI(dominoTile tilesOnHand[], int numTilesOnHand) {
-    // La modalità AI ha bisogno di avere le tessere speciali in un array separato
-    // così da poter verificarle dopo ogni tessera normale inserita.
+void playAI(dominoTile tilesOnHand[], int numTilesOnHand, aiOptions options) {
+    // Tutte le situazioni di gioco della ricerca vengono prese dal pool e liberate insieme alla fine
+    beginBoardPool();
+
+    /** Strutture condivise dalla ricerca: la tabella delle trasposizioni evita di risolvere più volte le
+     * situazioni di gioco raggiunte mettendo le stesse tessere in ordine diverso */
+    aiContext context = createAIContext(options);
+
+    /** Inizio della ricerca */
+    long long start = getTimeUs();
+    /** Risultato AI calcolato dalla funzione ricorsiva */
+    gameSituation *bestGame = findBestGameAI(tilesOnHand, numTilesOnHand, &context);
+
+    // Il risultato JSON è lo stesso di una riga della modalità batch, con le mosse, il tempo e le statistiche
+    if (options.outputFormat == OUTPUT_JSON) {
+        printBatchResult(stdout, 1, numTilesOnHand, bestGame, getTimeUs() - start, &context);
+        freeGameSituation(bestGame);
+        freeAIContext(&context);
+        endBoardPool();
+        return;
+    }
+
+    // Dato il risultato stampa il gioco finale
+    if (options.outputFormat == OUTPUT_RLE) {
+        /** Campo in codifica run-length */
+        textBuffer buffer = createTextBuffer(TEXT_BUFFER_SIZE);
+        renderBoardRLE(&buffer, bestGame);
+        appendText(&buffer, "\n");
+        writeTextBuffer(stdout, &buffer);
+        freeTextBuffer(&buffer);
+    } else {
+        printAI(bestGame);
+    }
+    if (options.printMoves) printMoveList(stdout, &context.bestMoves);
+    if (options.mctsPlayouts > 0 && context.timedOut)
+        printf("Ricerca Monte Carlo: la partita potrebbe non essere la migliore\n");
+    else if (options.budgetMs > 0)
+        printf(context.timedOut ? "Tempo esaurito: la partita potrebbe non essere la migliore\n" : "La partita e' la migliore possibile\n");
+    if (options.stats) {
+        printf("Situazioni di gioco esplorate: %lld\n", context.nodes);
+        printSearchStats(stdout, &threadStats, numTilesOnHand);
+    }
+
+    // Libera il risultato allocato in mem dinamica
+    freeGameSituation(bestGame);
+    freeAIContext(&context);
+    endBoardPool();
+}
+
+/**
+ * Crea le strutture condivise dalla ricerca AI, riutilizzabili per più mani con findBestGameAI
+ * @param options opzioni della ricerca
+ * @returns strutture della ricerca, da liberare con freeAIContext
+ */
+aiContext createAIContext(aiOptions options) {
+    aiContext context = {
+            // Con più thread ogni thread ha la sua tabella
+            .table = options.threads > 1 ? NULL : createTranspositionTable(DEFAULT_TABLE_SIZE_LOG2),
+            // Il file viene solo mappato, le pagine vengono lette quando la ricerca le usa
+            .tablebase = options.tablebasePath ? openTablebase(options.tablebasePath) : NULL,
+            .options = options,
+            .bestScore = NO_SCORE,
+            .nodes = 0,
+            .shared = NULL,
+            .taskIndex = 0,
+            .tasks = NULL,
+            .deadline = 0,
+            .timedOut = false,
+            .incumbent = {.moves = NULL, .numMoves = 0, .score = NO_SCORE},
+            .numTiles = 0,
+            .path = NULL,
+            .lines = NULL,
+            .bestMoves = {.moves = NULL, .numMoves = 0, .score = NO_SCORE}
+    };
+    return context;
+}
+
+/**
+ * Libera le strutture della ricerca create con createAIContext
+ * @param context strutture della ricerca
+ */
+void freeAIContext(aiContext *context) {
+    freeTranspositionTable(context->table);
+    closeTablebase(context->tablebase);
+    context->table = NULL;
+    context->tablebase = NULL;
+    freeMoveLists(context);
+}
+
+/**
+ * Trova la migliore partita con le tessere date. La tabella delle trasposizioni del contesto non viene svuotata:
+ * le voci dipendono solo dalle tessere rimaste in mano e dal campo, quindi valgono anche per le mani successive.
+ * @param tilesOnHand array di tessere (almeno una normale)
+ * @param numTilesOnHand numero di tessere
+ * @param context strutture della ricerca create con createAIContext, alla fine contengono le statistiche della mano
+ * e le mosse della partita trovata (context->bestMoves)
+ * @returns migliore partita trovata, da liberare con freeGameSituation
+ */
+gameSituation *findBestGameAI(dominoTile tilesOnHand[], int numTilesOnHand, aiContext *context) {
+    /** Opzioni della ricerca */
+    aiOptions options = context->options;
+
+    context->bestScore = NO_SCORE;
+    context->nodes = 0;
+    resetSearchStats(options.stats);
+    context->deadline = options.budgetMs > 0 ? getTimeMs() + options.budgetMs : 0;
+    context->timedOut = false;
+    allocMoveLists(context, numTilesOnHand);
+    // La ricerca parte dal campo vuoto
+    memset(&context->counts, 0, sizeof(boardCounts));
+
+    // Su una sola fila e senza tessere speciali la migliore partita si trova senza ricerca, con qualsiasi numero di tessere
+    if(options.trailSolver && canSolveAsTrail(tilesOnHand, numTilesOnHand, options.vertical))
+        return getBestTrailGame(tilesOnHand, numTilesOnHand, &context->bestMoves);
+
+    // Su una sola fila, anche con tessere speciali, la programmazione dinamica risolve ogni situazione una volta sola
+    // se la sua tabella sta nella memoria concessa; altrimenti si usa la ricerca
+    if(options.subsetDP && !options.vertical){
+        /** Memoria necessaria alla programmazione dinamica, in MB arrotondati per eccesso */
+        long long megabytes = estimateSubsetDPBytes(tilesOnHand, numTilesOnHand) / (1024 * 1024) + 1;
+        if(megabytes > options.subsetDPMaxMb){
+            fprintf(stderr, "Programmazione dinamica: servono %lld MB (limite %ld MB), uso la ricerca\n",
+                    megabytes, options.subsetDPMaxMb);
+        }else{
+            // Le situazioni di gioco esplorate sono le voci della tabella calcolate
+            gameSituation *dpGame = getBestSubsetDPGame(tilesOnHand, numTilesOnHand, &context->nodes, &context->bestMoves);
+            if(dpGame) return dpGame;
+            fprintf(stderr, "Programmazione dinamica: memoria insufficiente, uso la ricerca\n");
+        }
+    }
+
+    // Le mani troppo grandi per la ricerca completa vengono giocate con la ricerca Monte Carlo
+    if(options.mctsPlayouts > 0) return getBestGameMCTS(tilesOnHand, numTilesOnHand, context);
 
     /**
-     * Numero di speciali che verrà aggiornato dalla funzione che le divide dalle normali,
-     * visto che la funzione non può ritornare 2 valori
+     * Righe allocate per la situazione di gioco iniziale: se le mosse vengono fatte direttamente su di essa deve poter
+     * contenere tutte le tessere (ogni tessera aggiunge al massimo una riga e due colonne)
      */
-    int numSpecials = 0;
-
-    /** Array di tessere speciali */
-    //dominoTile *specialsOnHand = get_specials_array(tilesOnHand, numTilesOnHand, &numSpecials);
+    int allocatedRows = options.inPlace || options.iterative ? numTilesOnHand + 1 : 1;
+    /** Colonne allocate per la situazione di gioco iniziale */
+    int allocatedCols = options.inPlace || options.iterative ? 2 * numTilesOnHand + 2 : 0;
+    /** Colonne allocate a sinistra della colonna 0: il campo cresce a sinistra senza spostare le celle */
+    int leftCols = options.inPlace || options.iterative ? 2 * numTilesOnHand : 0;
 
     /** Situzione di gioco iniziale(vuota a questo punto) */
     gameSituation defaultGame = {
-            .inGameDominoTiles = createInGameDominoTiles(1, 0),
+            .inGameDominoTiles = createInGameDominoTiles(allocatedRows, allocatedCols, leftCols),
             .rows = 1,
             .cols = 0,
-            .score = 0
+            .score = 0,
+            .leftCols = leftCols,
+            .maxLeftCols = leftCols,
+            .allocatedRows = allocatedRows
     };
 
-    /** Risultato AI calcolato dalla funzione ricorsiva */
-    gameSituation *bestGame = getBestGameAI(tilesOnHand, numTilesOnHand, &defaultGame);
+    /** Tessere in mano contate per tipo */
+    tileHand hand = createTileHand(tilesOnHand, numTilesOnHand);
 
-    // Dato il risultato stampa il gioco finale
-    printAI(bestGame);
+    // La ricerca restituisce solo il punteggio, le mosse della migliore partita sono in context->lines[numTilesOnHand]
+    if(options.threads > 1)
+        getBestGameParallel(&hand, &defaultGame, context);
+    else
+        searchBestGame(&hand, &defaultGame, NO_SCORE, context);
+    // Se il tempo è finito il risultato della ricerca interrotta non è affidabile: vale la migliore partita trovata
+    if(context->timedOut && context->incumbent.score != NO_SCORE)
+        copyMoveList(&context->bestMoves, &context->incumbent);
+    else
+        copyMoveList(&context->bestMoves, &context->lines[numTilesOnHand]);
 
     // Libera la matrice allocata dinamicamente per situazione di gioco iniziale
-    freeInGameDominoTiles(defaultGame.inGameDominoTiles, defaultGame.rows);
-
-    // Libera il risultato allocato in mem dinamica
-    freeGameSituation(bestGame);
+    freeInGameDominoTiles(defaultGame.inGameDominoTiles, allocatedRows);
+    // Il campo della partita viene costruito una volta sola, rifacendo le sue mosse
+    return replayMoves(&context->bestMoves, numTilesOnHand);
 }
 
 /**
  * Funzione ricorsiva che prova tutte le combinazioni per trovare la migliore situazione di gioco.
- * @param tilesOnHand tessere generate
- * @param numTilesOnHand numero di tessere generate
+ * Le combinazioni che non possono superare il punteggio toBeat non interessano al chiamante e vengono scartate.
+ * @param hand tessere in mano, modificata durante la ricerca e ripristinata alla fine
  * @param defaultGame situazione di gioco fino a questo momento
- * @returns miglior situazione di gioco con le tessere date inserite nella situazione di gioco data
- */
-gameSituation *getBestGameAI(dominoTile *tilesOnHand,
-                             int numTilesOnHand,
-                             gameSituation *defaultGame){
-    // CASO BASE 1: sono finite le tessere speciali e !endGame
-    // => verifica le tessere normali se sono finite, se non ci sono più adiacenze con queste
-    // oppure se si è a inizio gioco e si sta cercando di mettere una speciale
-    if(endGame(numTilesOnHand, tilesOnHand, *defaultGame))
-        return defaultGame;
-
-    /** Miglior situazione di gioco */
-    gameSituation *best = NULL;
+ * @param toBeat punteggio da superare, NO_SCORE se qualsiasi situazione di gioco va bene
+ * @param context strutture condivise dalla ricerca
+ * @returns punteggio della migliore partita con le tessere date messe nella situazione di gioco data, le sue mosse
+ * sono in context->lines[hand->numTiles]; NO_SCORE se non si può superare toBeat
+ */
+int getBestGameAI(tileHand *hand,
+                             gameSituation *defaultGame,
+                             int toBeat,
+                             aiContext *context){
+    /** Dati della situazione di gioco esplorata */
+    searchNode node;
+    // CASI BASE: partita finita, tempo finito, situazione di gioco già risolta o che non può superare toBeat
+    if(!beginSearchNode(hand, defaultGame, toBeat, context, &node)) return node.best;
+
+    // Ogni tipo di tessera in mano viene provato una volta sola, anche se ce ne sono più copie
+    for (int i = 0; i < NUM_TILE_TYPES; ++i) {
+        /** Tipo di tessera da provare */
+        int type = context->options.moveOrdering ? getOrderedType(i) : i;
+        if(hand->counts[type] == 0) continue;
+        /** Tessera da inserire */
+        dominoTile tile = getTileOfType(type);
+        /** Punteggio della migliore partita con questa tessera */
+        int actualBestIn;
+        removeTileFromHand(hand, type);
+        // Se sono all'inizio della partita metto una tessera normale in orizzontale come prima tessera in gioco
+        if(defaultGame->score == 0 && !isSpecialType(type) && context->options.inPlace){
+            // Come sotto, ma la tessera viene messa e poi tolta dalla situazione di gioco data
+            placeFirstTile(defaultGame, &context->counts, tile);
+            recordMove(context, hand, tile, 0, 0, HORIZONTAL, NOT_VALID_CHAR);
+
+            actualBestIn = getBestGameAI(hand, defaultGame, scoreToBeat(node.toBeat, node.best), context);
+            if(actualBestIn != NO_SCORE) keepLine(context, hand);
+
+            removeFirstTile(defaultGame, &context->counts);
+        }else if(defaultGame->score == 0 && !isSpecialType(type)){
+            gameSituation *in = copyGame(*defaultGame, HORIZONTAL, 0);
+            /** Contatori del campo senza la tessera, ripristinati dopo aver esplorato la copia */
+            boardCounts counts = context->counts;
+
+            placeFirstTile(in, &context->counts, tile);
+            recordMove(context, hand, tile, 0, 0, HORIZONTAL, NOT_VALID_CHAR);
+
+            // Continua la ricorsione sulle prossime tessere meno questa
+            actualBestIn = getBestGameAI(hand, in, scoreToBeat(node.toBeat, node.best), context);
+            if(actualBestIn != NO_SCORE) keepLine(context, hand);
+            freeGameSituation(in);
+            context->counts = counts;
+        }else{
+            // Controlla la tessera attuale in tutte le posizioni e poi sfrutta la ricorsione successivamente
+            actualBestIn = bestGameTileIn(hand, tile, *defaultGame, scoreToBeat(node.toBeat, node.best), node.symmetric, context);
+        }
+        addTileToHand(hand, type);
+
+        // Un punteggio restituito supera sempre quello da battere passato, quindi anche la migliore partita finora
+        if(actualBestIn > node.best) node.best = actualBestIn;
+    }
+
+    endSearchNode(hand, defaultGame, context, &node);
+    return node.best;
+}
+
+/**
+ * Trova la migliore partita con la ricerca scelta dalle opzioni: iterativa (iterative_ai.h) o ricorsiva
+ * @param hand tessere in mano, modificata durante la ricerca e ripristinata alla fine
+ * @param game situazione di gioco (con spazio per tutte le tessere se la ricerca è iterativa)
+ * @param toBeat punteggio da superare, NO_SCORE se qualsiasi situazione di gioco va bene
+ * @param context strutture condivise dalla ricerca
+ * @returns punteggio della migliore partita come getBestGameAI
+ */
+int searchBestGame(tileHand *hand, gameSituation *game, int toBeat, aiContext *context){
+    if(context->options.iterative) return getBestGameIterative(hand, game, toBeat, context);
+    return getBestGameAI(hand, game, toBeat, context);
+}
+
+/**
+ * Inizia l'esplorazione di una situazione di gioco, con gli stessi controlli per la ricerca ricorsiva e per quella
+ * iterativa: conta la situazione, controlla il tempo e la fine della partita, raccoglie i sottoproblemi della ricerca
+ * parallela e alza il punteggio da superare con il pruning, la tablebase e la tabella delle trasposizioni.
+ * @param hand tessere in mano
+ * @param game situazione di gioco
+ * @param toBeat punteggio da superare, NO_SCORE se qualsiasi situazione di gioco va bene
+ * @param context strutture condivise dalla ricerca
+ * @param node dati della situazione di gioco da inizializzare
+ * @returns se vanno provate le mosse, altrimenti node->best è già il risultato (NO_SCORE se non supera toBeat)
+ */
+bool beginSearchNode(tileHand *hand, gameSituation *game, int toBeat, aiContext *context, searchNode *node){
+    node->toBeat = toBeat;
+    node->best = NO_SCORE;
+    node->key = 0;
+    node->symmetric = false;
+    context->nodes++;
+    countNode(hand->numTiles);
+    // Se il tempo a disposizione è finito la ricerca viene interrotta, resta la migliore partita trovata finora
+    if(context->deadline && isTimeOver(context)) return false;
+    /** Se la partita è finita */
+    bool finished = endGameHand(hand, game, &context->counts);
+    // Se si stanno raccogliendo i sottoproblemi per la ricerca parallela ci si ferma dopo le prime mosse
+    if(context->tasks && (finished || hand->numTiles <= context->tasks->splitAt)){
+        addTask(context->tasks, hand, *game, &context->counts, context->path, context->numTiles - hand->numTiles);
+        return false;
+    }
+    if(finished){
+        // Partita finita: è la migliore trovata finora se supera tutte le precedenti
+        updateBestScore(context, game->score);
+        if(context->deadline) updateIncumbent(context, hand, game->score);
+        // Al chiamante basta il punteggio, le mosse vengono copiate solo se interessano
+        if(game->score <= toBeat) return false;
+        saveLine(context, hand, game->score);
+        node->best = game->score;
+        return false;
+    }
+
+    if(context->options.pruning){
+        // Una partita finita prima di questa ha già il punteggio migliore trovato: se questa situazione di gioco
+        // non può superarlo non serve esplorarla (a parità di punteggio vince la partita trovata prima)
+        /** Punteggio della migliore partita trovata finora */
+        int bestSoFar = getBestScoreSoFar(context);
+        if(bestSoFar > node->toBeat) node->toBeat = bestSoFar;
+        // Neanche mettendo tutte le tessere rimaste al massimo dei punti si supera il punteggio da battere
+        if(maxReachableScore(hand, *game) <= node->toBeat)
+            return false;
+    }
+
+    // Su una sola fila, con poche tessere normali in mano, il miglior punteggio aggiuntivo è già nella tablebase:
+    // come con un valore esatto della tabella delle trasposizioni basta ritrovare la prima combinazione che lo raggiunge
+    if(context->tablebase && !context->options.vertical && game->score != 0
+       && hand->numTiles <= context->tablebase->maxTiles){
+        /** Valori delle estremità della fila */
+        int leftValue, rightValue;
+        /** Miglior punteggio aggiuntivo della tablebase */
+        int tablebaseValue;
+        getRowEnds(*game, &leftValue, &rightValue);
+        if(probeTablebase(context->tablebase, hand, leftValue, rightValue, &tablebaseValue)){
+            threadStats.tablebaseHits++;
+            if(game->score + tablebaseValue <= node->toBeat)
+                return false;
+            node->toBeat = game->score + tablebaseValue - 1;
+        }
+    }
+
+    /** Se la situazione di gioco ha lo stesso miglior punteggio aggiuntivo della sua immagine speculare */
+    bool mirrorInvariant = isMirrorInvariant(hand, &context->counts, context->options);
+    // Se il campo è uguale alla sua immagine speculare ogni mossa a destra dà l'immagine speculare di una mossa
+    // a sinistra, provata prima e con lo stesso punteggio, quindi basta provare quelle a sinistra
+    node->symmetric = mirrorInvariant && game->score != 0 && isMirrorSymmetric(*game);
+
+    if(context->table){
+        // Una situazione di gioco e la sua immagine speculare condividono la voce della tabella
+        node->key = mirrorInvariant ? hashLinearGameState(hand, *game) : hashGameState(hand, *game);
+        /** Miglior punteggio aggiuntivo già calcolato per questa situazione di gioco */
+        int storedValue;
+        /** Tipo di valore salvato: esatto o limite superiore */
+        char storedBound;
+        if(probeTranspositionTable(context->table, node->key, &storedValue, &storedBound)){
+            // La situazione di gioco è già stata risolta e non può superare il punteggio da battere
+            if(game->score + storedValue <= node->toBeat)
+                return false;
+            // Se il punteggio migliore è già noto basta ritrovare la prima combinazione che lo raggiunge,
+            // quelle che non ci arrivano vengono scartate subito
+            if(storedBound == EXACT_SCORE)
+                node->toBeat = game->score + storedValue - 1;
+        }
+    }
+    return true;
+}
+
+/**
+ * Finisce l'esplorazione di una situazione di gioco di cui sono state provate tutte le mosse, salvando il risultato
+ * nella tabella delle trasposizioni: se supera toBeat è il migliore possibile, altrimenti si sa solo che non supera
+ * toBeat. Se la ricerca è stata interrotta il risultato non è affidabile e non viene salvato.
+ * @param hand tessere in mano
+ * @param game situazione di gioco
+ * @param context strutture condivise dalla ricerca
+ * @param node dati della situazione di gioco, con il punteggio della migliore partita trovata
+ */
+void endSearchNode(tileHand *hand, gameSituation *game, aiContext *context, searchNode *node){
+    if(!context->table || context->timedOut) return;
     /**
-     * Copia array speciali che verrà modificato spostandole verso sinistra per provarle tutte.
-     * Lo crea statico e verrà passato direttamente a una funzione per la modifica, per evitare ulteriori malloc.
+     * Punteggio da superare più alto che può essere stato usato dalle situazioni di gioco successive: con più
+     * thread la migliore partita condivisa può essere migliorata dagli altri thread durante la ricerca
      */
-    dominoTile copyTilesOnHand[numTilesOnHand];
-    copyDominoTileAr(tilesOnHand, copyTilesOnHand, numTilesOnHand);
-    for (int i = 0; i < numTilesOnHand; ++i) {
-        // Controlla se la tessera non è già stata controllata precedentemente(=> non c'è prima nell'array originale)
-        if(!hasThisTileIn(*copyTilesOnHand, tilesOnHand, i)){
-            gameSituation *actualBestIn;
-            /** Tessera da inserire speciale o no */
-            bool isSpecial = copyTilesOnHand->left == 0 || copyTilesOnHand->left == 11 || copyTilesOnHand->left == 12;
-            // Se sono all'inizio della partita metto una tessera normale in orizzontale come prima tessera in gioco
-            if(defaultGame->score == 0 && !isSpecial){
-                gameSituation *in = copyGame(*defaultGame, HORIZONTAL, 0);
-
-                dominoTileSide left = {.value = copyTilesOnHand->left, .side = LEFT, .orientation = HORIZONTAL};
-                in->inGameDominoTiles[0][0] = left;
-                dominoTileSide right = {.value = copyTilesOnHand->right, .side = RIGHT, .orientation = HORIZONTAL};
-                in->inGameDominoTiles[0][1] = right;
-                in->score = copyTilesOnHand->left + copyTilesOnHand->right;
-
-                // Continua la ricorsione sulle prossime tessere meno questa
-                actualBestIn = getBestGameAI(copyTilesOnHand+1, numTilesOnHand-1, in);
-                if (actualBestIn != in) freeGameSituation(in);
-            }else{
-                // Controlla la tessera attuale in tutte le posizioni e poi sfrutta la ricorsione successivamente
-                actualBestIn = bestGameTileIn(copyTilesOnHand, numTilesOnHand, *defaultGame);
-            }
+    int bound = node->toBeat;
+    if(context->shared && context->options.pruning && getBestScoreSoFar(context) > bound)
+        bound = getBestScoreSoFar(context);
+    if(node->best > node->toBeat && node->best >= bound)
+        storeTranspositionTable(context->table, node->key, node->best - game->score, EXACT_SCORE, hand->numTiles);
+    else
+        storeTranspositionTable(context->table, node->key, bound - game->score, UPPER_SCORE, hand->numTiles);
+}
+
+/**
+ * Mette la prima tessera in orizzontale nelle prime due celle di una situazione di gioco vuota
+ * @param game situazione di gioco vuota, con almeno due colonne allocate
+ * @param counts contatori del campo
+ * @param tile tessera normale da mettere
+ */
+void placeFirstTile(gameSituation *game, boardCounts *counts, dominoTile tile){
+    game->cols = 2;
+    placeSide(game, counts, 0, 0, tile.left, LEFT);
+    placeSide(game, counts, 0, 1, tile.right, RIGHT);
+    game->score = tile.left + tile.right;
+}
+
+/**
+ * Toglie la prima tessera messa con placeFirstTile, lasciando la situazione di gioco vuota
+ * @param game situazione di gioco con la sola prima tessera
+ * @param counts contatori del campo
+ */
+void removeFirstTile(gameSituation *game, boardCounts *counts){
+    removeSide(game, counts, 0, 0);
+    removeSide(game, counts, 0, 1);
+    game->cols = 0;
+    game->score = 0;
+}
+
+/**
+ * Restituisce il punteggio che una nuova situazione di gioco deve superare per interessare al chiamante:
+ * il massimo tra quello richiesto dal chiamante e quello della migliore situazione trovata finora.
+ * @param toBeat punteggio da superare richiesto dal chiamante
+ * @param best punteggio della migliore partita trovata finora, NO_SCORE se non ce ne sono
+ * @returns punteggio da superare
+ */
+int scoreToBeat(int toBeat, int best){
+    return best > toBeat ? best : toBeat;
+}
+
+/**
+ * Restituisce il punteggio della migliore partita finita trovata finora: con più thread è quello condiviso,
+ * diminuito di 1 se è stato trovato in un sottoproblema successivo a quello attuale (a parità di punteggio
+ * vince il sottoproblema che la ricerca su un solo thread esplorerebbe prima).
+ * @param context strutture condivise dalla ricerca
+ * @returns punteggio da superare per migliorare la migliore partita trovata
+ */
+int getBestScoreSoFar(aiContext *context){
+    if(context->shared) return readSharedBestScore(context->shared, context->taskIndex);
+    return context->bestScore;
+}
+
+/**
+ * Aggiorna il punteggio della migliore partita finita trovata finora
+ * @param context strutture condivise dalla ricerca
+ * @param score punteggio di una partita finita
+ */
+void updateBestScore(aiContext *context, int score){
+    if(context->shared) updateSharedBestScore(context->shared, score, context->taskIndex);
+    else if(score > context->bestScore) context->bestScore = score;
+}
+
+/**
+ * Restituisce il tempo trascorso da un istante fisso
+ * @returns millisecondi
+ */
+long long getTimeMs(void){
+    return getTimeNs() / 1000000;
+}
+
+/**
+ * Restituisce il tempo trascorso da un istante fisso, in microsecondi
+ * @returns microsecondi
+ */
+long long getTimeUs(void){
+    return getTimeNs() / 1000;
+}
+
+/**
+ * Restituisce il tempo trascorso da un istante fisso, in nanosecondi
+ * @returns nanosecondi
+ */
+long long getTimeNs(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * Controlla se il tempo a disposizione della ricerca è finito. L'orologio viene letto solo ogni TIME_CHECK_INTERVAL
+ * situazioni di gioco esplorate, e la ricerca non viene interrotta finché non c'è una partita finita da restituire.
+ * @param context strutture condivise dalla ricerca
+ * @returns se la ricerca deve fermarsi
+ */
+bool isTimeOver(aiContext *context){
+    if(context->timedOut) return true;
+    if((context->nodes & (TIME_CHECK_INTERVAL - 1)) != 0) return false;
+    // Con più thread basta che un thread abbia trovato una partita finita
+    if(context->incumbent.score == NO_SCORE && !(context->shared && getBestScoreSoFar(context) > NO_SCORE)) return false;
+    if(getTimeMs() >= context->deadline) context->timedOut = true;
+    return context->timedOut;
+}
+
+/**
+ * Tiene le mosse della partita finita se è la migliore trovata finora
+ * @param context strutture condivise dalla ricerca
+ * @param hand tessere rimaste in mano a fine partita
+ * @param score punteggio della partita finita
+ */
+void updateIncumbent(aiContext *context, tileHand *hand, int score){
+    if(context->incumbent.score < score){
+        memcpy(context->incumbent.moves, context->path, sizeof(placedTile) * (context->numTiles - hand->numTiles));
+        context->incumbent.numMoves = context->numTiles - hand->numTiles;
+        context->incumbent.score = score;
+    }
+}
+
+/**
+ * Alloca le liste di mosse della ricerca per una partita con il numero di tessere dato, liberando le precedenti
+ * @param context strutture della ricerca
+ * @param numTiles tessere in mano all'inizio della partita
+ */
+void allocMoveLists(aiContext *context, int numTiles){
+    freeMoveLists(context);
+    context->numTiles = numTiles;
+    /** Mosse di ogni lista: una partita ha al più una mossa per tessera */
+    int width = numTiles > 0 ? numTiles : 1;
+    // Tutte le mosse in un solo blocco: il percorso, la partita di ogni livello, quella del limite di tempo e il risultato
+    context->path = (placedTile *) malloc(sizeof(placedTile) * width * (numTiles + 4));
+    context->lines = (moveList *) malloc(sizeof(moveList) * (numTiles + 1));
+    for (int i = 0; i <= numTiles; ++i) {
+        context->lines[i].moves = context->path + (i + 1) * width;
+        context->lines[i].numMoves = 0;
+        context->lines[i].score = NO_SCORE;
+    }
+    context->incumbent.moves = context->path + (numTiles + 2) * width;
+    context->incumbent.numMoves = 0;
+    context->incumbent.score = NO_SCORE;
+    context->bestMoves.moves = context->path + (numTiles + 3) * width;
+    context->bestMoves.numMoves = 0;
+    context->bestMoves.score = NO_SCORE;
+}
+
+/**
+ * Libera le liste di mosse allocate con allocMoveLists
+ * @param context strutture della ricerca
+ */
+void freeMoveLists(aiContext *context){
+    free(context->path);
+    free(context->lines);
+    context->path = NULL;
+    context->lines = NULL;
+    context->incumbent.moves = context->bestMoves.moves = NULL;
+    context->incumbent.numMoves = context->bestMoves.numMoves = 0;
+    context->incumbent.score = context->bestMoves.score = NO_SCORE;
+}
+
+/**
+ * Salva nel percorso la mossa fatta per arrivare alla prossima situazione di gioco
+ * @param context strutture della ricerca
+ * @param hand tessere in mano senza la tessera messa
+ * @param tile tessera messa, già girata se serve
+ * @param row riga della tessera in gioco alla quale viene attaccata
+ * @param col colonna della tessera in gioco alla quale viene attaccata
+ * @param orientation orientamento della tessera
+ * @param isLinkedTo da che lato della tessera in gioco viene attaccata, NOT_VALID_CHAR per la prima tessera
+ */
+void recordMove(aiContext *context, tileHand *hand, dominoTile tile, int row, int col, char orientation, char isLinkedTo){
+    /** Mossa da salvare */
+    placedTile *move = &context->path[context->numTiles - hand->numTiles - 1];
+    move->tile = tile;
+    move->row = row;
+    move->col = col;
+    move->orientation = orientation;
+    move->isLinkedTo = isLinkedTo;
+}
+
+/**
+ * Salva le mosse di una partita finita come migliore partita della situazione di gioco
+ * @param context strutture della ricerca
+ * @param hand tessere rimaste in mano a fine partita
+ * @param score punteggio della partita
+ */
+void saveLine(aiContext *context, tileHand *hand, int score){
+    /** Partita della situazione di gioco */
+    moveList *line = &context->lines[hand->numTiles];
+    line->numMoves = context->numTiles - hand->numTiles;
+    line->score = score;
+    memcpy(line->moves, context->path, sizeof(placedTile) * line->numMoves);
+}
+
+/**
+ * Tiene la migliore partita trovata dopo una mossa come migliore partita della situazione di gioco prima della mossa
+ * (va chiamata solo quando la migliore partita migliora: quella trovata dopo la mossa verrà sovrascritta dalla prossima)
+ * @param context strutture della ricerca
+ * @param hand tessere in mano senza la tessera messa
+ */
+void keepLine(aiContext *context, tileHand *hand){
+    copyMoveList(&context->lines[hand->numTiles + 1], &context->lines[hand->numTiles]);
+}
 
-            if(actualBestIn && (!best || best->score < actualBestIn->score)){
-                if(best) freeGameSituation(best);
-                best = actualBestIn;
-            }else{
-                freeGameSituation(actualBestIn);
+/**
+ * Copia una lista di mosse in un'altra che abbia spazio a sufficienza
+ * @param to lista in cui copiare
+ * @param from lista da copiare
+ */
+void copyMoveList(moveList *to, moveList *from){
+    memcpy(to->moves, from->moves, sizeof(placedTile) * from->numMoves);
+    to->numMoves = from->numMoves;
+    to->score = from->score;
+}
+
+/**
+ * Costruisce il campo da gioco di una partita rifacendo le sue mosse
+ * @param moves mosse della partita (almeno la prima tessera)
+ * @param numTiles tessere in mano all'inizio della partita
+ * @returns partita con le mosse fatte, da liberare con freeGameSituation
+ */
+gameSituation *replayMoves(moveList *moves, int numTiles){
+    /** Righe allocate: ogni tessera aggiunge al massimo una riga e due colonne */
+    int allocatedRows = numTiles + 1;
+    /** Situazione di gioco su cui rifare le mosse */
+    gameSituation game = {
+            .inGameDominoTiles = createInGameDominoTiles(allocatedRows, 2 * numTiles + 2, 2 * numTiles),
+            .rows = 1,
+            .cols = 2,
+            .score = 0,
+            .leftCols = 2 * numTiles,
+            .maxLeftCols = 2 * numTiles,
+            .allocatedRows = allocatedRows
+    };
+    /** Contatori del campo, servono per il punteggio delle [11|11] */
+    boardCounts counts = {.valueCounts = {0}, .openEnds = {0}};
+    /** Prima tessera, in orizzontale */
+    dominoTile first = moves->moves[0].tile;
+    placeSide(&game, &counts, 0, 0, first.left, LEFT);
+    placeSide(&game, &counts, 0, 1, first.right, RIGHT);
+    game.score = first.left + first.right;
+    for (int i = 1; i < moves->numMoves; ++i) {
+        /** Mossa da rifare */
+        placedTile *move = &moves->moves[i];
+        undoRecord undo;
+        makeMove(&game, &counts, move->tile, move->row, move->col, move->orientation, move->isLinkedTo, &undo);
+    }
+    /** Copia grande quanto il campo */
+    gameSituation *result = copyGame(game, NOT_VALID_CHAR, NOT_VALID_INT);
+    freeInGameDominoTiles(game.inGameDominoTiles, allocatedRows);
+    return result;
+}
+
+/**
+ * Stampa le mosse di una partita, una per riga: la tessera (come era in mano, girata se serve) e la tessera in gioco
+ * a cui viene attaccata, con le coordinate del campo prima della mossa
+ * @param out file su cui stampare
+ * @param moves mosse della partita
+ */
+void printMoveList(FILE *out, moveList *moves){
+    for (int i = 0; i < moves->numMoves; ++i) {
+        /** Mossa da stampare */
+        placedTile *move = &moves->moves[i];
+        fprintf(out, "%d) [%d|%d]", i + 1, move->tile.left, move->tile.right);
+        if (move->isLinkedTo == NOT_VALID_CHAR)
+            fprintf(out, " prima tessera\n");
+        else
+            fprintf(out, " %s, a %s della cella (%d, %d)\n", move->orientation == HORIZONTAL ? "orizzontale" : "verticale",
+                    move->isLinkedTo == LEFT ? "sinistra" : "destra", move->row, move->col);
+    }
+}
+
+
+/**
+ * Restituisce il valore massimo che può assumere un lato di tessera con valore dato se vengono messe
+ * al più numIncrements tessere [11|11] (che incrementano i valori e trasformano 6 in 1).
+ * @param value valore attuale del lato
+ * @param numIncrements numero di tessere [11|11] che possono ancora essere messe
+ * @returns valore massimo raggiungibile
+ */
+int maxReachableValue(int value, int numIncrements){
+    // Lo 0 non viene incrementato
+    if(value == 0) return 0;
+    return (value + numIncrements >= 6) ? 6 : value + numIncrements;
+}
+
+/**
+ * Calcola un limite superiore del punteggio finale raggiungibile da una situazione di gioco: ogni lato in gioco e ogni lato
+ * delle tessere rimaste assume il valore massimo che può raggiungere con le [11|11] in mano, le [12|21] e le [11|11] copiano
+ * lati di tessere e quindi valgono al più 6 + 6, le [0|0] valgono 0.
+ * @param hand tessere in mano
+ * @param game situazione di gioco
+ * @returns limite superiore del punteggio finale
+ */
+int maxReachableScore(tileHand *hand, gameSituation game){
+    /** Numero di tessere [11|11] in mano */
+    int numIncrements = hand->counts[INCREMENT_TYPE];
+
+    /** Limite superiore calcolato */
+    int bound = 0;
+    if(numIncrements == 0){
+        // Senza [11|11] i lati in gioco non cambiano più valore
+        bound = game.score;
+    }else{
+        for (int row = 0; row < game.rows; ++row) {
+            for (int cell = 0; cell < game.cols; ++cell) {
+                if(game.inGameDominoTiles[row][cell] != EMPTY_CELL)
+                    bound += maxReachableValue(getSideValue(&game, row, cell), numIncrements);
             }
         }
-        move_left(copyTilesOnHand, numTilesOnHand, *copyTilesOnHand);
     }
+    for (int type = 0; type < NUM_TILE_TYPES; ++type) {
+        if(hand->counts[type] == 0) continue;
+        /** Tessera del tipo attuale */
+        dominoTile tile = getTileOfType(type);
+        switch (type) {
+            case ZERO_TYPE:
+                break;
+            case INCREMENT_TYPE:
+            case MIRROR_TYPE:
+                bound += 12 * hand->counts[type];
+                break;
+            default:
+                bound += hand->counts[type] * (maxReachableValue(tile.left, numIncrements) + maxReachableValue(tile.right, numIncrements));
+        }
+    }
+    return bound;
+}
 
-    return best;
+/**
+ * Trova le estremità dei tratti di tessere in gioco di ogni riga, gli unici punti a cui può essere attaccata una
+ * tessera: in orizzontale a sinistra di un'estremità sinistra o a destra di un'estremità destra, in verticale
+ * sotto un'estremità sul bordo del campo.
+ * @param game situazione di gioco
+ * @param points array in cui salvare le estremità, grande almeno quanto il numero di celle del campo
+ * @returns numero di estremità trovate, salvate nell'ordine delle celle della matrice
+ */
+int getAttachPoints(gameSituation game, attachPoint *points){
+    /** Numero di estremità trovate */
+    int numPoints = 0;
+    for (int row = 0; row < game.rows; ++row) {
+        /** Riga del campo */
+        dominoTileSide *cells = game.inGameDominoTiles[row];
+        for (int cell = 0; cell < game.cols; ++cell) {
+            if(cells[cell] == EMPTY_CELL) continue;
+            /** Se la cella è il primo lato di un tratto */
+            bool leftEnd = cell == 0 || cells[cell - 1] == EMPTY_CELL;
+            /** Se la cella è l'ultimo lato di un tratto */
+            bool rightEnd = cell == game.cols - 1 || cells[cell + 1] == EMPTY_CELL;
+            if(leftEnd || rightEnd){
+                points[numPoints].row = row;
+                points[numPoints].col = cell;
+                points[numPoints].leftEnd = leftEnd;
+                points[numPoints].rightEnd = rightEnd;
+                numPoints++;
+            }
+        }
+    }
+    return numPoints;
 }
 
 /**
  * Ritorna la situazione di gioco migliore con la tessera attuale dentro nella sua posizione migliore controllandole
  * tutte e sfruttando la funzione ricorsiva.
- * @param tilesOnHand puntatore alla prima tessera generata, dopo la quale sequenzialmente ci sono le altre
- * @param numTilesOnHand numero di tessere generate
+ * @param hand tessere in mano senza la tessera da inserire
+ * @param tile tessera da inserire
  * @param defaultGame situazione di gioco fino a questo momento
- * @returns situazione di gioco migliore con l'attuale tessera inserita nella sua posizione migliore nella situazione di gioco data
- */
-gameSituation *bestGameTileIn(dominoTile *tilesOnHand,
-                              int numTilesOnHand,
-                              gameSituation defaultGame) {
-
-    /** Puntatore alla migliore situazione di gioco */
-    gameSituation *bestIn = NULL;
-
-    // Per ogni lato delle tessere in gioco(=> ogni lato è in una cella della matrice)
-    // devo controllare l'adiacenza con la tesera passata
-    for (int row = 0; row < defaultGame.rows; ++row) {
-        for (int cell = 0; cell < defaultGame.cols; ++cell) {
-            // Caso 1: la tessera in gioco adiacente è in orizzontale, l'attuale tessera può essere
-            // attacata o a destra(H e V) o a sinistra(H e V) e questo dipende che lato è la tessera in gioco
-            // Controlla che la mossa sia valida anche in caso di reversed
-
-            // TESSERA COLLEGATA A SINISTRA
-            gameSituation *in_H_L =  bestTileInEachPosition(tilesOnHand, numTilesOnHand, defaultGame, HORIZONTAL, LEFT, row, cell);
-            if (in_H_L){
-                if (!bestIn || bestIn->score < in_H_L->score) {
-                    if(bestIn) freeGameSituation(bestIn);
-                    bestIn = in_H_L;
-                } else {
-                    freeGameSituation(in_H_L);
-                }
-            }
+ * @param toBeat punteggio da superare
+ * @param symmetric se il campo è uguale alla sua immagine speculare (vengono provate solo le mosse a sinistra)
+ * @param context strutture condivise dalla ricerca
+ * @returns punteggio della migliore partita con l'attuale tessera inserita nella sua posizione migliore nella situazione
+ * di gioco data (mosse in context->lines), NO_SCORE se non supera toBeat
+ */
+int bestGameTileIn(tileHand *hand,
+                              dominoTile tile,
+                              gameSituation defaultGame,
+                              int toBeat,
+                              bool symmetric,
+                              aiContext *context) {
 
-            // TESSERA COLLEGATA A SINISTRA VERTICALE
-            gameSituation *in_V_L =  bestTileInEachPosition(tilesOnHand, numTilesOnHand, defaultGame, VERTICAL, LEFT, row, cell);
-            if (in_V_L){
-                if (!bestIn || bestIn->score < in_V_L->score) {
-                    if(bestIn) freeGameSituation(bestIn);
-                    bestIn = in_V_L;
-                } else {
-                    freeGameSituation(in_V_L);
-                }
-            }
+    /** Punteggio della migliore partita */
+    int bestIn = NO_SCORE;
 
-            // TESSERA COLLEGATA A DESTRA
-            gameSituation *in_H_R =  bestTileInEachPosition(tilesOnHand, numTilesOnHand, defaultGame, HORIZONTAL, RIGHT, row, cell);
-            if (in_H_R){
-                if (!bestIn || bestIn->score < in_H_R->score) {
-                    if(bestIn) freeGameSituation(bestIn);
-                    bestIn = in_H_R;
-                } else {
-                    freeGameSituation(in_H_R);
-                }
-            }
+    // Le tessere possono essere attaccate solo alle estremità dei tratti di tessere di ogni riga:
+    // vengono controllate solo quelle, nello stesso ordine delle celle della matrice
+    /** Estremità dei tratti di tessere in gioco */
+    attachPoint points[defaultGame.rows * defaultGame.cols + 1];
+    /** Numero di estremità */
+    int numPoints = getAttachPoints(defaultGame, points);
+    /** Mosse da provare: per ogni estremità al massimo 4 (orizzontale e verticale, a sinistra e a destra) */
+    candidateMove moves[4 * numPoints + 1];
+    /** Numero di mosse da provare */
+    int numMoves = getCandidateMoves(hand, tile, &defaultGame, symmetric, context, points, numPoints, moves);
 
-            // TESSERA COLLEGATA A DESTRA VERTICALE
-            gameSituation *in_V_R =  bestTileInEachPosition(tilesOnHand, numTilesOnHand, defaultGame, VERTICAL, RIGHT, row, cell);
-            if (in_V_R){
-                if (!bestIn || bestIn->score < in_V_R->score) {
-                    if(bestIn) freeGameSituation(bestIn);
-                    bestIn = in_V_R;
-                } else {
-                    freeGameSituation(in_V_R);
-                }
-            }
-        }
+    for (int i = 0; i < numMoves; ++i) {
+        // Controlla che la mossa sia valida anche in caso di reversed
+        int in = bestTileInEachPosition(hand, tile, defaultGame, moves[i].orientation, moves[i].isLinkedTo,
+                                        moves[i].row, moves[i].col, scoreToBeat(toBeat, bestIn), context);
+        if (in > bestIn) bestIn = in;
     }
     return bestIn;
 }
 
+/**
+ * Prepara le mosse da provare con una tessera alle estremità trovate da getAttachPoints
+ * @param hand tessere in mano senza la tessera da inserire
+ * @param tile tessera da inserire
+ * @param game situazione di gioco
+ * @param symmetric se il campo è uguale alla sua immagine speculare (vengono preparate solo le mosse a sinistra)
+ * @param context strutture condivise dalla ricerca
+ * @param points estremità dei tratti di tessere in gioco
+ * @param numPoints numero di estremità
+ * @param moves array in cui salvare le mosse, grande almeno 4 * numPoints
+ * @returns numero di mosse da provare
+ */
+int getCandidateMoves(tileHand *hand, dominoTile tile, gameSituation *game, bool symmetric, aiContext *context,
+                      attachPoint *points, int numPoints, candidateMove *moves){
+    /** Numero di mosse da provare */
+    int numMoves = 0;
+    for (int i = 0; i < numPoints; ++i) {
+        /** Riga dell'estremità */
+        int row = points[i].row;
+        /** Colonna dell'estremità */
+        int cell = points[i].col;
+        // Caso 1: la tessera in gioco adiacente è in orizzontale, l'attuale tessera può essere
+        // attacata o a destra(H e V) o a sinistra(H e V) e questo dipende che lato è la tessera in gioco
+
+        // TESSERA COLLEGATA A SINISTRA
+        if (points[i].leftEnd)
+            addCandidateMove(moves, &numMoves, row, cell, HORIZONTAL, LEFT);
+        // TESSERA COLLEGATA A SINISTRA VERTICALE
+        if (cell == 0 && context->options.vertical)
+            addCandidateMove(moves, &numMoves, row, cell, VERTICAL, LEFT);
+        // TESSERA COLLEGATA A DESTRA
+        if (points[i].rightEnd && !symmetric)
+            addCandidateMove(moves, &numMoves, row, cell, HORIZONTAL, RIGHT);
+        // TESSERA COLLEGATA A DESTRA VERTICALE
+        if (cell == game->cols - 1 && context->options.vertical)
+            addCandidateMove(moves, &numMoves, row, cell, VERTICAL, RIGHT);
+    }
+    if (context->options.moveOrdering) orderCandidateMoves(moves, numMoves, hand, tile, game);
+    return numMoves;
+}
+
+/**
+ * Aggiunge una mossa alla lista delle mosse da provare
+ * @param moves lista delle mosse
+ * @param numMoves puntatore al numero di mosse, aggiornato
+ * @param row riga della tessera in gioco alla quale attaccare la tessera
+ * @param col colonna della tessera in gioco alla quale attaccare la tessera
+ * @param orientation orientamento della tessera da mettere
+ * @param isLinkedTo da che lato della tessera in gioco attaccare la tessera
+ */
+void addCandidateMove(candidateMove *moves, int *numMoves, int row, int col, char orientation, char isLinkedTo){
+    moves[*numMoves].row = row;
+    moves[*numMoves].col = col;
+    moves[*numMoves].orientation = orientation;
+    moves[*numMoves].isLinkedTo = isLinkedTo;
+    moves[*numMoves].priority = 0;
+    (*numMoves)++;
+}
+
+/**
+ * Ordina le mosse da provare mettendo prima quelle che lasciano scoperto un valore presente in più tessere in mano,
+ * così la ricerca trova presto partite lunghe e il pruning scarta di più. A parità resta l'ordine delle celle.
+ * Le mosse con le tessere speciali restano nell'ordine delle celle.
+ * @param moves mosse da ordinare
+ * @param numMoves numero di mosse
+ * @param hand tessere in mano senza la tessera da inserire
+ * @param tile tessera da inserire
+ * @param game situazione di gioco
+ */
+void orderCandidateMoves(candidateMove *moves, int numMoves, tileHand *hand, dominoTile tile, gameSituation *game){
+    if (tile.left == 0 || tile.left == 11 || tile.left == 12 || numMoves < 2) return;
+    /** Per ogni valore, tessere in mano che lo hanno su almeno un lato (accanto ad uno 0 vanno bene tutte) */
+    int tilesWithValue[7] = {hand->numTiles, 0, 0, 0, 0, 0, 0};
+    for (int type = 0; type < NUM_NORMAL_TYPES; ++type) {
+        if (hand->counts[type] == 0) continue;
+        /** Tessera del tipo attuale */
+        dominoTile inHand = getTileOfType(type);
+        tilesWithValue[inHand.left] += hand->counts[type];
+        if (inHand.right != inHand.left) tilesWithValue[inHand.right] += hand->counts[type];
+    }
+    for (int i = 0; i < numMoves; ++i) {
+        /** Lato scoperto dalla mossa */
+        int exposed = getExposedValue(tile, game, &moves[i]);
+        moves[i].priority = exposed == NOT_VALID_INT ? -1 : tilesWithValue[exposed];
+    }
+    // Insertion sort stabile: le mosse sono poche
+    for (int i = 1; i < numMoves; ++i) {
+        candidateMove move = moves[i];
+        int j = i - 1;
+        while (j >= 0 && moves[j].priority < move.priority) {
+            moves[j + 1] = moves[j];
+            j--;
+        }
+        moves[j + 1] = move;
+    }
+}
+
+/**
+ * Restituisce il valore del lato di una tessera normale che resta scoperto dopo averla attaccata, girandola se serve
+ * come bestTileInEachPosition (accanto ad uno 0 la tessera non viene girata)
+ * @param tile tessera da inserire, con il numero più piccolo a sinistra
+ * @param game situazione di gioco
+ * @param move mossa
+ * @returns valore scoperto, NOT_VALID_INT se i valori non combaciano
+ */
+int getExposedValue(dominoTile tile, gameSituation *game, candidateMove *move){
+    /** Valore della tessera in gioco a cui attaccare la tessera */
+    int adjacent = getSideValue(game, move->row, move->col);
+    /** Se la tessera non girata si collega con il lato destro (in orizzontale a sinistra), negli altri casi con il sinistro */
+    bool rightLinked = move->orientation == HORIZONTAL && move->isLinkedTo == LEFT;
+    /** Lato che si collega alla tessera in gioco se la tessera non viene girata */
+    int linked = rightLinked ? tile.right : tile.left;
+    /** Altro lato della tessera non girata */
+    int other = rightLinked ? tile.left : tile.right;
+    if (adjacent == 0 || linked == adjacent) return other;
+    if (other == adjacent) return linked;
+    return NOT_VALID_INT;
+}
+
+/**
+ * Controlla se una situazione di gioco ha lo stesso miglior punteggio aggiuntivo della sua immagine speculare.
+ * Succede solo giocando su una sola fila: in verticale la tessera attaccata a destra di una tessera verticale nella
+ * prima colonna finisce a sinistra e il campo cresce in modo diverso a destra e a sinistra. Inoltre non ci devono
+ * essere [0|0], perché accanto ad uno 0 la tessera viene provata solo non girata.
+ * @param hand tessere in mano
+ * @param counts contatori del campo della situazione di gioco
+ * @param options opzioni della ricerca
+ * @returns se la situazione di gioco e la sua immagine speculare sono equivalenti
+ */
+bool isMirrorInvariant(tileHand *hand, boardCounts *counts, aiOptions options){
+    return !options.vertical && hand->counts[ZERO_TYPE] == 0 && counts->valueCounts[0] == 0;
+}
+
+/**
+ * Controlla se la fila di tessere in gioco letta da destra è uguale a quella letta da sinistra
+ * @param game situazione di gioco con tutte le tessere in orizzontale nella prima riga
+ * @returns se il campo è uguale alla sua immagine speculare
+ */
+bool isMirrorSymmetric(gameSituation game){
+    /** Riga del campo */
+    dominoTileSide *cells = game.inGameDominoTiles[0];
+    /** Prima colonna occupata */
+    int first = 0;
+    /** Ultima colonna occupata */
+    int last = game.cols - 1;
+    while (first <= last && cells[first] == EMPTY_CELL) first++;
+    while (last >= first && cells[last] == EMPTY_CELL) last--;
+    // Le [11|11] non ancora applicate cambiano allo stesso modo tutti i valori: basta confrontare quelli salvati
+    for (; first < last; first++, last--) {
+        if (getCellValue(cells[first]) != getCellValue(cells[last])) return false;
+    }
+    return true;
+}
+
+/**
+ * Restituisce i valori delle estremità della fila di tessere in gioco
+ * @param game situazione di gioco con tutte le tessere in orizzontale nella prima riga
+ * @param leftValue puntatore in cui salvare il valore dell'estremità sinistra
+ * @param rightValue puntatore in cui salvare il valore dell'estremità destra
+ */
+void getRowEnds(gameSituation game, int *leftValue, int *rightValue){
+    /** Riga del campo */
+    dominoTileSide *cells = game.inGameDominoTiles[0];
+    /** Prima colonna occupata */
+    int first = 0;
+    /** Ultima colonna occupata */
+    int last = game.cols - 1;
+    while (first < last && cells[first] == EMPTY_CELL) first++;
+    while (last > first && cells[last] == EMPTY_CELL) last--;
+    *leftValue = getSideValue(&game, 0, first);
+    *rightValue = getSideValue(&game, 0, last);
+}
+
 /**
  * Restituisce la migliore situazione di gioco(sfruttando la funzione ricorsiva) con la tessera passata dopo
  * averla aggiunta nella posizione specificata dai parametri
- * @param tilesOnHand puntatore alla prima tessera generata, dopo la quale sequenzialmente ci sono le altre
- * @param numTilesOnHand numero di tessere generate
+ * @param hand tessere in mano senza la tessera da inserire
+ * @param tile tessera da inserire
  * @param defaultGame situazione di gioco fino a questo momento
  * @param tileToPutOrientation orintamento della tessera da mettere
  * @param isLinkedTo da che lato dovrebbe essere collegata la tessera passata a quella in gioco
  * @param rowAdjacent riga tessera in gioco alla quale quella da aggiugere dovrebbe essere adiacente
  * @param cellAdjacent colonna tessera in gioco alla quale quella da aggiugere dovrebbe essere adiacente
- * @returns NULL se mossa non valida oppure puntatore alla situazione di gioco migliore allocata in memoria dinamica
+ * @param toBeat punteggio da superare
+ * @param context strutture condivise dalla ricerca
+ * @returns NO_SCORE se la mossa non è valida o non supera toBeat, altrimenti punteggio della migliore partita con la
+ * mossa: le sue mosse diventano la migliore partita della situazione di gioco data (context->lines)
  */
-gameSituation *bestTileInEachPosition(dominoTile *tilesOnHand,
-                                      int numTilesOnHand,
+int bestTileInEachPosition(tileHand *hand,
+                                      dominoTile tile,
                                       gameSituation defaultGame,
                                       char tileToPutOrientation,
                                       char isLinkedTo,
                                       int rowAdjacent,
-                                      int cellAdjacent){
-    /** Puntatore alla migliore situazione di gioco con la tessera attuale dentro nella posizione passata */
-    gameSituation *bestIn = NULL;
+                                      int cellAdjacent,
+                                      int toBeat,
+                                      aiContext *context){
+    /** Punteggio della migliore partita con la tessera attuale dentro nella posizione passata */
+    int bestIn = NO_SCORE;
     /** Tessera da inserire nel gioco */
-    dominoTile tileToAdd = *tilesOnHand;
+    dominoTile tileToAdd = tile;
 
     /** Tessera da inserire speciale o no */
-   bool isSpecial = tilesOnHand->left == 0 || tilesOnHand->left == 11 || tilesOnHand->left == 12;
+   bool isSpecial = tile.left == 0 || tile.left == 11 || tile.left == 12;
 
-    /** Salva se la mossa con la tessera attuale è valida */
-    bool validAdjacency = isValidMove(tileToAdd, defaultGame, rowAdjacent, cellAdjacent, tileToPutOrientation, isLinkedTo);
-    // Se non è adiacente la tessera di default verifica anche reversed
-    if(!validAdjacency){
-        rotateDominoTile(&tileToAdd);
-        validAdjacency = isValidMove(tileToAdd, defaultGame, rowAdjacent, cellAdjacent, tileToPutOrientation, isLinkedTo);
-    }
+    /** Salva se la mossa con la tessera attuale (o girata) è valida */
+    bool validAdjacency = fitTile(&tileToAdd, defaultGame, rowAdjacent, cellAdjacent, tileToPutOrientation, isLinkedTo);
+    if (validAdjacency) recordMove(context, hand, tileToAdd, rowAdjacent, cellAdjacent, tileToPutOrientation, isLinkedTo);
     // Se tessera normale o girata ha adiacenze
-    if (validAdjacency){
+    if (validAdjacency && context->options.inPlace){
+        // La situazione di gioco è passata per valore ma condivide la matrice: la mossa viene fatta direttamente
+        // sulla matrice e annullata dopo la ricorsione
+        undoRecord undo;
+        makeMove(&defaultGame, &context->counts, tileToAdd, rowAdjacent, cellAdjacent, tileToPutOrientation, isLinkedTo, &undo);
+        bestIn = getBestGameAI(hand, &defaultGame, toBeat, context);
+        undoMove(&defaultGame, &context->counts, &undo);
+    }else if (validAdjacency){
         /** Copia della situazione di gioco in cui inserire la tessera orizzontale */
         gameSituation *tileInGame = copyGame(defaultGame, tileToPutOrientation, cellAdjacent);
+        /** Contatori del campo senza la tessera, ripristinati dopo aver esplorato la copia */
+        boardCounts counts = context->counts;
         if (isSpecial)
-            fixSpecialTiles(&tileToAdd, tileInGame, rowAdjacent, cellAdjacent, tileToPutOrientation, isLinkedTo);
-        addDominoTile(tileInGame, tileToAdd, rowAdjacent, cellAdjacent, tileToPutOrientation, isLinkedTo);
-        bestIn = getBestGameAI(tilesOnHand+1, numTilesOnHand-1, tileInGame);
-        // Se non è la stessa situazione di gioco precedente perchè la ricorsione è finita
-        if (bestIn != tileInGame) freeGameSituation(tileInGame);
+            applySpecialTile(&tileToAdd, tileInGame, &context->counts, rowAdjacent, cellAdjacent, tileToPutOrientation, isLinkedTo);
+        addDominoTile(tileInGame, &context->counts, tileToAdd, rowAdjacent, cellAdjacent, tileToPutOrientation, isLinkedTo);
+        bestIn = getBestGameAI(hand, tileInGame, toBeat, context);
+        freeGameSituation(tileInGame);
+        context->counts = counts;
     }
+    // Un punteggio restituito supera toBeat, quindi anche la migliore partita trovata finora dal chiamante
+    if (bestIn != NO_SCORE) keepLine(context, hand);
     return bestIn;
 }
 
+/**
+ * Controlla se una tessera può essere attaccata nella posizione data, girandola se serve
+ * @param tile tessera da inserire, girata se la mossa è valida solo girandola
+ * @param game situazione di gioco
+ * @param row riga della tessera in gioco alla quale attaccare la tessera
+ * @param col colonna della tessera in gioco alla quale attaccare la tessera
+ * @param orientation orientamento della tessera da mettere
+ * @param isLinkedTo da che lato della tessera in gioco attaccare la tessera
+ * @returns se la mossa è valida con la tessera com'è o girata
+ */
+bool fitTile(dominoTile *tile, gameSituation game, int row, int col, char orientation, char isLinkedTo){
+    threadStats.validMoveCalls++;
+    if(isValidMove(*tile, game, row, col, orientation, isLinkedTo)) return true;
+    // Se non è adiacente la tessera di default verifica anche reversed
+    rotateDominoTile(tile);
+    threadStats.validMoveCalls++;
+    return isValidMove(*tile, game, row, col, orientation, isLinkedTo);
+}
+
 /**
  * Esegue la free di una situazione di gioco allocata in memoria dinamica
  * @param game situazione di gioco allocata dinamicamente
@@ -235,256 +1076,374 @@ gameSituation *bestTileInEachPosition(dominoTile *tilesOnHand,
 void freeGameSituation(gameSituation *game){
     if(game){
         freeInGameDominoTiles(game->inGameDominoTiles, game->rows);
-        free(game);
+        freeBoardMemory(game);
     }
 }
 
 /**
- * Aggiunge al gioco la tessera in base alla posizione in cui aggiungere e il suo orientamento
- * facendo lo split tra i due lati.
- * @param game situazione di gioco da modificare aggiungendo la tessera
- * @param tileToPut tessera da aggiungere
+ * Calcola dove finisce nel campo una tessera aggiunta in base alla posizione in cui aggiungerla e al suo orientamento.
  * @param rowTileInGame riga della tessera alla quale collegare quella in mano
  * @param colTileInGame colonna della tessera alla quale collegare quella in mano
  * @param orientationTileToPut orientamento della tessera da mettere
  * @param isLinkedTo da che parte si collega la tessera a quella in gioco, LEFT or RIGHT
+ * @returns posizione del primo lato della tessera (quello sinistro o in alto) e colonne di cui va spostato il campo
  */
-void addDominoTile(gameSituation *game, dominoTile tileToPut, int rowTileInGame, int colTileInGame, char orientationTileToPut, char isLinkedTo){
+tilePlacement getTilePlacement(int rowTileInGame, int colTileInGame, char orientationTileToPut, char isLinkedTo){
+    tilePlacement placement = {.row = rowTileInGame, .col = colTileInGame, .shift = 0, .orientation = orientationTileToPut};
     // Se la tessera adiacente in gioco è sulla colonna 0, bisogna spostare tutto a destra di 1 oppure 2 colonne in base
     // ad orientamento della tessera in gioco.
     if(colTileInGame == 0 && orientationTileToPut == HORIZONTAL){
-       moveRight(game, 2);
-       // Aggiunta della tessera
-       game->inGameDominoTiles[rowTileInGame][0].value = tileToPut.left;
-       game->inGameDominoTiles[rowTileInGame][0].orientation = HORIZONTAL;
-       game->inGameDominoTiles[rowTileInGame][0].side = LEFT;
+        placement.shift = 2;
+        placement.col = 0;
+    }else if(isLinkedTo == LEFT && ((colTileInGame == 0 && orientationTileToPut == VERTICAL) || (colTileInGame == 1 && orientationTileToPut == HORIZONTAL))){
+        // Sposta solo di 1, la tessera verticale sul bordo oppure quella orizzontale prima del bordo finiscono sulla colonna 0
+        placement.shift = 1;
+        placement.col = 0;
+    }else if(isLinkedTo == LEFT){
+        // Posizione in base al lato al quale è collegata
+        placement.col = (orientationTileToPut == HORIZONTAL) ? colTileInGame - 2 : colTileInGame - 1;
+    }else{
+        placement.col = colTileInGame + 1;
+    }
+    return placement;
+}
 
-       game->inGameDominoTiles[rowTileInGame][1].value = tileToPut.right;
-       game->inGameDominoTiles[rowTileInGame][1].orientation = HORIZONTAL;
-       game->inGameDominoTiles[rowTileInGame][1].side = RIGHT;
+/**
+ * Aggiunge al gioco la tessera in base alla posizione in cui aggiungere e il suo orientamento
+ * facendo lo split tra i due lati.
+ * @param game situazione di gioco da modificare aggiungendo la tessera
+ * @param counts contatori del campo
+ * @param tileToPut tessera da aggiungere
+ * @param rowTileInGame riga della tessera alla quale collegare quella in mano
+ * @param colTileInGame colonna della tessera alla quale collegare quella in mano
+ * @param orientationTileToPut orientamento della tessera da mettere
+ * @param isLinkedTo da che parte si collega la tessera a quella in gioco, LEFT or RIGHT
+ * @return se lo spostamento del campo ha spostato l'inizio delle righe invece delle celle (moveRight)
+ */
+bool addDominoTile(gameSituation *game, boardCounts *counts, dominoTile tileToPut, int rowTileInGame, int colTileInGame, char orientationTileToPut, char isLinkedTo){
+    /** Posizione della tessera da aggiungere */
+    tilePlacement placement = getTilePlacement(rowTileInGame, colTileInGame, orientationTileToPut, isLinkedTo);
+    /** Se il campo è stato spostato spostando l'inizio delle righe */
+    bool movedRowStarts = false;
+    if(placement.shift > 0) movedRowStarts = moveRight(game, placement.shift);
 
-    }else if(isLinkedTo == LEFT && ((colTileInGame == 0 && orientationTileToPut == VERTICAL) || (colTileInGame == 1 && orientationTileToPut == HORIZONTAL))){
-        // Sposta solo di 1
-        moveRight(game, 1);
-        if(colTileInGame == 0){ // Caso in cui la tessera è verticale e si è sul bordo
-            game->inGameDominoTiles[rowTileInGame][0].value = tileToPut.left;
-            game->inGameDominoTiles[rowTileInGame][0].orientation = VERTICAL;
-            game->inGameDominoTiles[rowTileInGame][0].side = TOP;
-
-            game->inGameDominoTiles[rowTileInGame+1][0].value = tileToPut.right;
-            game->inGameDominoTiles[rowTileInGame+1][0].orientation = VERTICAL;
-            game->inGameDominoTiles[rowTileInGame+1][0].side = BOTTOM;
-        }else{ // Caso in cui la tessera è in orizzontale e prima del bordo
-            game->inGameDominoTiles[rowTileInGame][0].value = tileToPut.left;
-            game->inGameDominoTiles[rowTileInGame][0].orientation = HORIZONTAL;
-            game->inGameDominoTiles[rowTileInGame][0].side = LEFT;
-
-            game->inGameDominoTiles[rowTileInGame][1].value = tileToPut.right;
-            game->inGameDominoTiles[rowTileInGame][1].orientation = HORIZONTAL;
-            game->inGameDominoTiles[rowTileInGame][1].side = RIGHT;
-        }
+    // Aggiunta della tessera
+    if(orientationTileToPut == HORIZONTAL){
+        placeSide(game, counts, placement.row, placement.col, tileToPut.left, LEFT);
+        placeSide(game, counts, placement.row, placement.col+1, tileToPut.right, RIGHT);
     }else{
-        // Aggiunta della tessera in base al lato al quale è collegata
-        if(isLinkedTo == LEFT && orientationTileToPut == HORIZONTAL){
-            game->inGameDominoTiles[rowTileInGame][colTileInGame-2].value = tileToPut.left;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame-2].orientation = HORIZONTAL;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame-2].side = LEFT;
-
-            game->inGameDominoTiles[rowTileInGame][colTileInGame-1].value = tileToPut.right;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame-1].orientation = HORIZONTAL;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame-1].side = RIGHT;
-        } else if(isLinkedTo == RIGHT && orientationTileToPut == HORIZONTAL){
-            game->inGameDominoTiles[rowTileInGame][colTileInGame+1].value = tileToPut.left;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame+1].orientation = HORIZONTAL;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame+1].side = LEFT;
-
-            game->inGameDominoTiles[rowTileInGame][colTileInGame+2].value = tileToPut.right;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame+2].orientation = HORIZONTAL;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame+2].side = RIGHT;
-        } else if(isLinkedTo == LEFT && orientationTileToPut == VERTICAL){
-            game->inGameDominoTiles[rowTileInGame][colTileInGame-1].value = tileToPut.left;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame-1].orientation = VERTICAL;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame-1].side = TOP;
-
-            game->inGameDominoTiles[rowTileInGame+1][colTileInGame-1].value = tileToPut.right;
-            game->inGameDominoTiles[rowTileInGame+1][colTileInGame-1].orientation = VERTICAL;
-            game->inGameDominoTiles[rowTileInGame+1][colTileInGame-1].side = BOTTOM;
-        } else if(isLinkedTo == RIGHT && orientationTileToPut == VERTICAL){
-            game->inGameDominoTiles[rowTileInGame][colTileInGame+1].value = tileToPut.left;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame+1].orientation = VERTICAL;
-            game->inGameDominoTiles[rowTileInGame][colTileInGame+1].side = TOP;
-
-            game->inGameDominoTiles[rowTileInGame+1][colTileInGame+1].value = tileToPut.right;
-            game->inGameDominoTiles[rowTileInGame+1][colTileInGame+1].orientation = VERTICAL;
-            game->inGameDominoTiles[rowTileInGame+1][colTileInGame+1].side = BOTTOM;
-        }
+        placeSide(game, counts, placement.row, placement.col, tileToPut.left, TOP);
+        placeSide(game, counts, placement.row+1, placement.col, tileToPut.right, BOTTOM);
     }
 
     // Aggiorna punteggio
     game->score += tileToPut.left + tileToPut.right;
+    return movedRowStarts;
+}
+
+/**
+ * Aggiunge una tessera alla situazione di gioco modificandola direttamente (senza copiarla) e salva
+ * tutto quello che serve per annullare la mossa con undoMove.
+ * La matrice della situazione di gioco deve avere spazio per le righe e le colonne aggiunte dalla mossa.
+ * @param game situazione di gioco da modificare
+ * @param counts contatori del campo
+ * @param tileToPut tessera da aggiungere
+ * @param rowTileInGame riga della tessera alla quale collegare quella in mano
+ * @param colTileInGame colonna della tessera alla quale collegare quella in mano
+ * @param orientationTileToPut orientamento della tessera da mettere
+ * @param isLinkedTo da che parte si collega la tessera a quella in gioco, LEFT or RIGHT
+ * @param undo dati per annullare la mossa
+ */
+void makeMove(gameSituation *game, boardCounts *counts, dominoTile tileToPut, int rowTileInGame, int colTileInGame, char orientationTileToPut, char isLinkedTo, undoRecord *undo){
+    undo->rows = game->rows;
+    undo->cols = game->cols;
+    undo->score = game->score;
+    undo->increment = tileToPut.left == 11;
+    undo->placement = getTilePlacement(rowTileInGame, colTileInGame, orientationTileToPut, isLinkedTo);
+
+    // Stesse righe e colonne della copia fatta da copyGame
+    getGrownSize(*game, orientationTileToPut, colTileInGame, &game->rows, &game->cols);
+    if (tileToPut.left == 0 || tileToPut.left == 11 || tileToPut.left == 12)
+        applySpecialTile(&tileToPut, game, counts, rowTileInGame, colTileInGame, orientationTileToPut, isLinkedTo);
+    undo->movedRowStarts = addDominoTile(game, counts, tileToPut, rowTileInGame, colTileInGame, orientationTileToPut, isLinkedTo);
+}
+
+/**
+ * Annulla una mossa fatta con makeMove: toglie la tessera, riporta le colonne nella posizione precedente allo
+ * spostamento, annulla l'incremento della [11|11] e ripristina righe, colonne e punteggio.
+ * @param game situazione di gioco modificata da makeMove
+ * @param counts contatori del campo
+ * @param undo dati salvati da makeMove
+ */
+void undoMove(gameSituation *game, boardCounts *counts, undoRecord *undo){
+    /** Cella del secondo lato della tessera */
+    int secondRow = undo->placement.orientation == HORIZONTAL ? undo->placement.row : undo->placement.row + 1;
+    int secondCol = undo->placement.orientation == HORIZONTAL ? undo->placement.col + 1 : undo->placement.col;
+    removeSide(game, counts, undo->placement.row, undo->placement.col);
+    removeSide(game, counts, secondRow, secondCol);
+
+    if(undo->placement.shift > 0) moveLeft(game, undo->placement.shift, undo->movedRowStarts);
+    if(undo->increment) game->increments = (game->increments + 5) % 6;
+
+    game->rows = undo->rows;
+    game->cols = undo->cols;
+    game->score = undo->score;
 }
 
 /**
- * Copia un array di dominoTile in un altro passato alla funzione, evitando di fare malloc per la copia.
- * @param from array da cui copiare
- * @param to array in cui copiare
- * @param size lunghezza array
+ * Sistema la tessera speciale da aggiungere come fixSpecialTiles, ma la [11|11] non incrementa le celle una per una:
+ * viene contata in game->increments e il punteggio viene aggiornato con il numero di celle per valore.
+ * @param tileToPut tessera speciale da aggiungere, aggiornata con i valori che assume
+ * @param game situazione di gioco da aggiornare
+ * @param counts contatori del campo
+ * @param row riga della tessera alla quale collegare quella speciale
+ * @param col colonna della tessera alla quale collegare quella speciale
+ * @param orientation orientamento della tessera da mettere
+ * @param isLinkedTo da che parte si collega la tessera a quella in gioco, LEFT or RIGHT
  */
-void copyDominoTileAr(dominoTile from[], dominoTile *to, int size){
-    for (int i = 0; i < size; ++i) {
-       to[i] = from[i];
+void applySpecialTile(dominoTile *tileToPut, gameSituation *game, boardCounts *counts, int row, int col, char orientation, char isLinkedTo){
+    /** Inizio, letto solo se il tempo va misurato */
+    long long start = threadStats.timeSpecials ? getTimeNs() : 0;
+    threadStats.specialTileCalls++;
+    if(tileToPut->left != 11){
+        fixSpecialTiles(tileToPut, game, row, col, orientation, isLinkedTo);
+    }else{
+        // Ogni lato diverso da 0 vale 1 in più, tranne i 6 che diventano 1 (5 in meno)
+        /** Celle con un valore diverso da 0 */
+        int numNonZero = 0;
+        for (int value = 1; value <= 6; ++value) numNonZero += counts->valueCounts[value];
+        game->score += numNonZero - 6 * counts->valueCounts[getStoredValue(game, 6)];
+        game->increments = (game->increments + 1) % 6;
+        // Copio il valore della cella adiacente
+        tileToPut->left = tileToPut->right = getSideValue(game, row, col);
     }
+    if(threadStats.timeSpecials) threadStats.specialTileNs += getTimeNs() - start;
 }
 
+/**
+ * Mette un lato di tessera in una cella vuota del campo
+ * @param game situazione di gioco
+ * @param counts contatori del campo
+ * @param row riga della cella
+ * @param col colonna della cella
+ * @param value valore del lato
+ * @param side quale lato della tessera è (l'orientamento della tessera dipende dal lato)
+ */
+void placeSide(gameSituation *game, boardCounts *counts, int row, int col, int value, char side){
+    /** Valore da salvare nella cella */
+    int stored = getStoredValue(game, value);
+    updateOpenEnds(game, counts, row, col, -1);
+    if(stored >= 0){
+        game->inGameDominoTiles[row][col] = packCell(stored, side);
+        counts->valueCounts[stored]++;
+        counts->openEnds[stored] += isLeftOpen(game, row, col) + isRightOpen(game, row, col);
+    }
+}
+
+/**
+ * Toglie un lato di tessera da una cella del campo
+ * @param game situazione di gioco
+ * @param counts contatori del campo
+ * @param row riga della cella
+ * @param col colonna della cella
+ */
+void removeSide(gameSituation *game, boardCounts *counts, int row, int col){
+    /** Valore salvato nella cella da svuotare */
+    int stored = getCellValue(game->inGameDominoTiles[row][col]);
+    if(stored >= 0){
+        counts->valueCounts[stored]--;
+        counts->openEnds[stored] -= isLeftOpen(game, row, col) + isRightOpen(game, row, col);
+    }
+    game->inGameDominoTiles[row][col] = EMPTY_CELL;
+    updateOpenEnds(game, counts, row, col, 1);
+}
+
+/**
+ * Toglie (sign = -1) o aggiunge (sign = 1) a counts->openEnds le estremità delle due celle prima e delle due dopo
+ * una cella vuota che guardano verso di essa: sono libere solo finché la cella resta vuota, gli altri lati delle
+ * celle vicine non dipendono dalla cella. Va chiamata prima di occupare la cella e dopo averla svuotata.
+ * @param game situazione di gioco
+ * @param counts contatori del campo
+ * @param row riga della cella vuota
+ * @param col colonna della cella vuota
+ * @param sign -1 prima di occupare la cella, 1 dopo averla svuotata
+ */
+void updateOpenEnds(gameSituation *game, boardCounts *counts, int row, int col, int sign){
+    /** Riga del campo */
+    dominoTileSide *cells = game->inGameDominoTiles[row];
+    for (int cell = col - 2; cell < col; ++cell) {
+        if(cell >= 0 && cells[cell] != EMPTY_CELL && isRightOpen(game, row, cell))
+            counts->openEnds[getCellValue(cells[cell])] += sign;
+    }
+    for (int cell = col + 1; cell <= col + 2; ++cell) {
+        if(cell < game->cols && cells[cell] != EMPTY_CELL && isLeftOpen(game, row, cell))
+            counts->openEnds[getCellValue(cells[cell])] += sign;
+    }
+}
+
+/**
+ * Controlla se si può attaccare una tessera in orizzontale a sinistra di una cella occupata, come controlla
+ * isValidMove: la cella è sulla prima colonna oppure le due celle prima sono vuote (o una sola prima del bordo).
+ * Quando il campo si allarga o le colonne vengono spostate le celle aggiunte sono vuote, quindi il risultato non cambia.
+ * @param game situazione di gioco
+ * @param row riga della cella
+ * @param col colonna della cella
+ * @returns se il lato sinistro della cella è un'estremità libera
+ */
+bool isLeftOpen(gameSituation *game, int row, int col){
+    /** Riga del campo */
+    dominoTileSide *cells = game->inGameDominoTiles[row];
+    return col == 0 || (cells[col - 1] == EMPTY_CELL && (col == 1 || cells[col - 2] == EMPTY_CELL));
+}
+
+/**
+ * Controlla se si può attaccare una tessera in orizzontale a destra di una cella occupata, come isLeftOpen
+ * @param game situazione di gioco
+ * @param row riga della cella
+ * @param col colonna della cella
+ * @returns se il lato destro della cella è un'estremità libera
+ */
+bool isRightOpen(gameSituation *game, int row, int col){
+    /** Riga del campo */
+    dominoTileSide *cells = game->inGameDominoTiles[row];
+    return col == game->cols - 1
+           || (cells[col + 1] == EMPTY_CELL && (col == game->cols - 2 || cells[col + 2] == EMPTY_CELL));
+}
+
+/**
+ * Restituisce i valori delle estremità libere del campo
+ * @param game situazione di gioco
+ * @param counts contatori del campo
+ * @returns maschera con il bit v acceso se si può attaccare una tessera in orizzontale ad una cella di valore v
+ */
+int getOpenValuesMask(gameSituation *game, boardCounts *counts){
+    int mask = 0;
+    for (int value = 0; value <= 6; ++value) {
+        if(counts->openEnds[value] > 0) mask |= 1 << getActualValue(game, value);
+    }
+    return mask;
+}
 
 /**
  * Copia una situazione di gioco in un altra situazione di gioco già data.
- * E aggiorna la copia in base alla tessera da inserire
+ * E aggiorna la copia in base alla tessera da inserire (con orientamento NOT_VALID_CHAR la copia è identica)
  * @param defaultGame situazione di gioco originale
  * @param toAddOrientation orientamento della tessera da inserire in base al quale aggiornare righe o colonne
  * @param toAddCell colonna in cui aggiungere la nuova tessera per capire se aumentare o no righe e colonne
  */
 gameSituation *copyGame(gameSituation defaultGame, char toAddOrientation, int toAddCell) {
     /** Numero di righe per la copia della situazione di gioco, aggiornato sulla posizione della tessera da inserire */
-    int newRows = defaultGame.rows;
+    int newRows;
     /** Numero di colonne per la copia della situazione di gioco, aggiornato sulla posizione della tessera da inserire */
-    int newCols = defaultGame.cols;
-    /** Se tessera deve essere inserita ai bordi */
-    bool borders = toAddCell == 0 || toAddCell == defaultGame.cols - 1;
-    /** Se tessera deve essere inserita una cella prima dei bordi */
-    bool beforeBorders = toAddCell == 1 || toAddCell == defaultGame.cols - 2;
-    //  Se tessera deve essere inserita ai bordi aggiorna il numero di colonne e righe in base alla posizione
-    if (toAddOrientation == HORIZONTAL && borders) {
-        newCols += 2;
-    }else if (toAddOrientation == HORIZONTAL && beforeBorders) {
-        newCols += 1;
-    }else if (toAddOrientation == VERTICAL && borders) {
-        newRows += 1;
-        newCols += 1;
-    }
+    int newCols;
+    getGrownSize(defaultGame, toAddOrientation, toAddCell, &newRows, &newCols);
+    threadStats.copyGameCalls++;
 
-    /** Copia dell'array di array dinamico contenente i lati delle tessere in gioco */
-    dominoTileSide **copyInDominoTileSides = copyMatrixSides(defaultGame, newRows,newCols);
+    /**
+     * Copia dell'array di array dinamico contenente i lati delle tessere in gioco, con le colonne a sinistra per
+     * aggiungere la tessera senza spostare le celle copiate
+     */
+    dominoTileSide **copyInDominoTileSides = copyMatrixSides(defaultGame, newRows, newCols, COPY_LEFT_COLS);
     /** Copia della situazione di gioco in memoria dinamica */
-    gameSituation *copy = (gameSituation*) malloc(sizeof(gameSituation));
+    gameSituation *copy = (gameSituation*) allocBoardMemory(sizeof(gameSituation));
+    *copy = defaultGame;
     copy->inGameDominoTiles = copyInDominoTileSides;
     copy->rows = newRows;
     copy->cols = newCols;
-    copy->score = defaultGame.score;
+    copy->leftCols = COPY_LEFT_COLS;
+    copy->maxLeftCols = COPY_LEFT_COLS;
+    copy->allocatedRows = newRows;
 
     return copy;
 }
 
+/**
+ * Calcola righe e colonne della situazione di gioco dopo aver inserito una tessera.
+ * @param game situazione di gioco originale
+ * @param toAddOrientation orientamento della tessera da inserire in base al quale aggiornare righe o colonne
+ * @param toAddCell colonna in cui aggiungere la nuova tessera per capire se aumentare o no righe e colonne
+ * @param newRows puntatore in cui salvare il numero di righe
+ * @param newCols puntatore in cui salvare il numero di colonne
+ */
+void getGrownSize(gameSituation game, char toAddOrientation, int toAddCell, int *newRows, int *newCols) {
+    *newRows = game.rows;
+    *newCols = game.cols;
+    /** Se tessera deve essere inserita ai bordi */
+    bool borders = toAddCell == 0 || toAddCell == game.cols - 1;
+    /** Se tessera deve essere inserita una cella prima dei bordi */
+    bool beforeBorders = toAddCell == 1 || toAddCell == game.cols - 2;
+    //  Se tessera deve essere inserita ai bordi aggiorna il numero di colonne e righe in base alla posizione
+    if (toAddOrientation == HORIZONTAL && borders) {
+        *newCols += 2;
+    }else if (toAddOrientation == HORIZONTAL && beforeBorders) {
+        *newCols += 1;
+    }else if (toAddOrientation == VERTICAL && borders) {
+        *newRows += 1;
+        *newCols += 1;
+    }
+}
+
 /**
  * Copia la matrice contenente i lati delle tessere in gioco.
  * @param originalGame situazione di gioco da cui copiare la matrice
  * @param rowsNewMat righe della nuova matrice
  * @param colsNewMat colonne della nuova matrice
+ * @param leftColsNewMat colonne della nuova matrice da allocare (vuote) a sinistra della colonna 0
  */
-dominoTileSide **copyMatrixSides(gameSituation originalGame, int rowsNewMat, int colsNewMat) {
+dominoTileSide **copyMatrixSides(gameSituation originalGame, int rowsNewMat, int colsNewMat, int leftColsNewMat) {
     /** Array di array dinamico in cui viene copiato quello originale */
-    dominoTileSide **copy = (dominoTileSide **) malloc((rowsNewMat) * sizeof(dominoTileSide*));
+    dominoTileSide **copy = allocInGameDominoTiles(rowsNewMat, colsNewMat, leftColsNewMat);
+    threadStats.bytesCopied += (long long) rowsNewMat * colsNewMat * sizeof(dominoTileSide);
+    /** Colonne copiate dalla matrice originale */
+    int copiedCols = originalGame.cols < colsNewMat ? originalGame.cols : colsNewMat;
     for (int i = 0; i < rowsNewMat; ++i) {
-        copy[i] = (dominoTileSide *) malloc((colsNewMat) * sizeof(dominoTileSide));
-        for (int j = 0; j < colsNewMat; ++j) {
-            // Se la matrice originale è più piccola, nei nuovi posti creati si mette NOT_VALID_INT
-            if (i >= originalGame.rows || j >= originalGame.cols) {
-                copy[i][j].value = NOT_VALID_INT;
-                copy[i][j].orientation = NOT_VALID_CHAR;
-                copy[i][j].side = NOT_VALID_CHAR;
-            } else {
-                copy[i][j] = originalGame.inGameDominoTiles[i][j];
-            }
+        memset(copy[i] - leftColsNewMat, EMPTY_CELL, leftColsNewMat);
+        // Se la matrice originale è più piccola, i nuovi posti creati restano vuoti
+        if (i < originalGame.rows) {
+            memcpy(copy[i], originalGame.inGameDominoTiles[i], copiedCols);
+            memset(copy[i] + copiedCols, EMPTY_CELL, colsNewMat - copiedCols);
+        } else {
+            memset(copy[i], EMPTY_CELL, colsNewMat);
         }
     }
     return copy;
 }
 
 /**
- * Verifica che su un dato array non ci sia la tessera inserita
- * @param toFound tessera da cercare
- * @param ar array in cui cercare
- * @param toCheckUntil fino a dove cercare
- * @returns se la tessera è presente
- */
-bool hasThisTileIn(dominoTile toFound, dominoTile *ar, int toCheckUntil){
-    for (int i = 0; i < toCheckUntil; ++i) {
-        if(ar[i].left == toFound.left && ar[i].right == toFound.right)
-            return true;
-    }
-    return false;
-}
-
-/**
- * Controlla se la tessera data(non speciale) ha adiacenze con le tessere della situazione di gioco data
- * @param tile tessera da verificare
+ * Controlla se la partita è finita, come endGame ma con le tessere in mano contate per tipo. Invece di provare ogni
+ * tessera in ogni cella confronta i valori delle estremità libere del campo con quelli delle tessere in mano.
+ * Le tessere verticali si attaccano solo alla prima e all'ultima colonna, dove va bene anche una tessera orizzontale
+ * con lo stesso valore: basta guardare le estremità libere in orizzontale.
+ * @param hand tessere in mano
  * @param game situazione di gioco
- * @returns se la tessera ha adiacenze
- */
-bool hasTileAdjacency(dominoTile tile, gameSituation game){
-    // Controllo se ci sono combinazioni disponibili
-    for (int row = 0; row < game.rows; row++) {
-        for (int cell = 0; cell < game.cols; cell++) {
-            if (game.inGameDominoTiles[row][cell].value != NOT_VALID_INT) { // Se c'è una tessera in gioco valida
-                if (isValidMove(tile, game, row, cell, HORIZONTAL, LEFT)
-                    || isValidMove(tile, game, row, cell, HORIZONTAL, RIGHT)
-                    || isValidMove(tile, game, row, cell, VERTICAL, LEFT)) {
-                        return true;
-                }
-                dominoTile tileReversed;
-                tileReversed.left=tile.right;
-                tileReversed.right=tile.left;
-                if (isValidMove(tileReversed, game, row, cell, HORIZONTAL, LEFT)
-                    || isValidMove(tileReversed, game, row, cell, HORIZONTAL, RIGHT)
-                    || isValidMove(tileReversed, game, row, cell, VERTICAL, LEFT)) {
-                        return true;
-                }
-            }
-        }
-    }
-    return false;
-}
+ * @param counts contatori del campo
+ * @returns se non ci sono più tessere in mano oppure nessuna può essere attaccata
+ */
+bool endGameHand(tileHand *hand, gameSituation *game, boardCounts *counts){
+    // Non ci sono più tessere in mano
+    if(hand->numTiles == 0) return true;
+    // Se non ho ancora messo tessere quindi punteggio della partita è 0
+    if(game->score == 0) return false;
+    // Le tessere speciali possono essere attaccate ovunque
+    if(hand->counts[ZERO_TYPE] || hand->counts[INCREMENT_TYPE] || hand->counts[MIRROR_TYPE]) return false;
 
-/**
- * Sposta l'array a sinistra e aggiunge alla fine la tessera data
- * (la prima tessera viene sovrascritta)
- * @param ar array di tessere da spostare
- * @param numTiles numero di tessere dell'array
- * @param to_add tessera da aggiungere
- * */
-void move_left(dominoTile *ar, int numTiles, dominoTile to_add){
-    for (int i = 0; i < numTiles-1; ++i) {
-        ar[i] = ar[i+1];
-    }
-    ar[numTiles-1] = to_add;
+    threadStats.endGameScans++;
+    /** Valori delle estremità libere */
+    int openValues = getOpenValuesMask(game, counts);
+    // Accanto ad uno 0 si può attaccare qualsiasi tessera
+    if(openValues & 1) return false;
+    return (openValues & getHandPipMask(hand)) == 0;
 }
 
-
 /**
- * Stampa il risultato della AI, ossia la migliore partita finita date le tessere generate.
+ * Stampa il risultato della AI, ossia la migliore partita finita date le tessere generate. Il campo viene disegnato
+ * in un buffer (renderBoard) e scritto con una sola chiamata.
  * @param game miglior situazione di gioco trovata dall'AI
  */
 void printAI(gameSituation *game) {
-    for (int row = 0; row < game->rows; ++row) {
-        for (int cell = 0; cell < game->cols; ++cell) {
-            if (game->inGameDominoTiles[row][cell].value == NOT_VALID_INT) {
-                printf("   ");
-            } else {
-                if (game->inGameDominoTiles[row][cell].orientation == HORIZONTAL && game->inGameDominoTiles[row][cell].side == LEFT) {
-                    printf("[%d|", game->inGameDominoTiles[row][cell].value);
-                } else if (game->inGameDominoTiles[row][cell].orientation == HORIZONTAL &&
-                           game->inGameDominoTiles[row][cell].side == RIGHT) {
-                    printf("|%d]", game->inGameDominoTiles[row][cell].value);
-                } else if (game->inGameDominoTiles[row][cell].orientation == VERTICAL &&
-                           game->inGameDominoTiles[row][cell].side == TOP) {
-                    printf("{%d:", game->inGameDominoTiles[row][cell].value);
-                } else if (game->inGameDominoTiles[row][cell].orientation == VERTICAL &&
-                           game->inGameDominoTiles[row][cell].side == BOTTOM) {
-                    printf(":%d}", game->inGameDominoTiles[row][cell].value);
-                }
-            }
-        }
-        if (row != game->rows-1) (printf("\n"));
-    }
-    printf("\n");
+    /** Disegno del campo, 3 caratteri per cella più l'a capo di ogni riga */
+    textBuffer buffer = createTextBuffer((size_t) game->rows * (3 * game->cols + 1));
+    renderBoard(&buffer, game);
+    writeTextBuffer(stdout, &buffer);
+    freeTextBuffer(&buffer);
 }
\ No newline at end of file
@@ -0,0 +1,275 @@
+/**
+ * @file batch.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la modalità batch: legge molte mani di tessere, una per riga, le risolve con l'AI
+ * e per ognuna stampa una riga JSON con il punteggio, il campo da gioco e il tempo impiegato.
+ * @date 17/10/2026
+ */
+
+#include "batch.h"
+
+/**
+ * Risolve tutte le mani lette da un file. Ogni riga contiene le tessere di una mano (ad esempio "[1|2][3|3][11|11]"
+ * oppure "1 2 3 3 11 11", vedi parseHandLine), le righe vuote e quelle che iniziano con # vengono saltate.
+ * La tabella delle trasposizioni e i blocchi del pool vengono creati una volta sola e riutilizzati per tutte le mani.
+ * @param in file da cui leggere le mani
+ * @param out file su cui scrivere una riga JSON per ogni mano
+ * @param options opzioni della ricerca
+ * @return numero di righe che non contenevano una mano valida
+ */
+int runBatch(FILE *in, FILE *out, aiOptions options) {
+    /** Strutture della ricerca condivise da tutte le mani */
+    aiContext context = createAIContext(options);
+    /** Buffer in cui viene letta la riga */
+    char *buffer = NULL;
+    /** Grandezza del buffer */
+    size_t capacity = 0;
+    /** Numero della riga letta */
+    long lineNumber = 0;
+    /** Numero di righe non valide */
+    int errors = 0;
+    /** Tessere della mano */
+    dominoTile tiles[MAX_BATCH_TILES];
+
+    beginBoardPool();
+    while (readBatchLine(in, &buffer, &capacity)) {
+        lineNumber++;
+        /** Messaggio di errore della riga */
+        const char *error = NULL;
+        /** Numero di tessere della mano */
+        int numTiles = parseHandLine(buffer, tiles, &error);
+        if (numTiles < 0) {
+            printBatchError(out, lineNumber, error);
+            errors++;
+            continue;
+        }
+        if (numTiles == 0) continue;
+
+        /** Inizio della ricerca */
+        long long start = getTimeUs();
+        /** Migliore partita della mano */
+        gameSituation *bestGame = findBestGameAI(tiles, numTiles, &context);
+        printBatchResult(out, lineNumber, numTiles, bestGame, getTimeUs() - start, &context);
+        freeGameSituation(bestGame);
+        // Le situazioni di gioco della mano non servono più, i blocchi grandi restano per la prossima
+        recycleBoardPool();
+    }
+    endBoardPool();
+
+    free(buffer);
+    freeAIContext(&context);
+    return errors;
+}
+
+/**
+ * Legge una riga intera, di qualsiasi lunghezza, ingrandendo il buffer se serve
+ * @param in file da cui leggere
+ * @param buffer puntatore al buffer (NULL la prima volta), da liberare con free
+ * @param capacity puntatore alla grandezza del buffer
+ * @return la riga letta (senza a capo) oppure NULL se il file è finito
+ */
+char *readBatchLine(FILE *in, char **buffer, size_t *capacity) {
+    /** Caratteri letti */
+    size_t length = 0;
+    if (*capacity == 0) {
+        *buffer = (char *) malloc(BATCH_LINE_SIZE);
+        if (!*buffer) return NULL;
+        *capacity = BATCH_LINE_SIZE;
+    }
+    while (fgets(*buffer + length, (int) (*capacity - length), in)) {
+        length += strlen(*buffer + length);
+        if (length > 0 && (*buffer)[length - 1] == '\n') {
+            (*buffer)[--length] = '\0';
+            if (length > 0 && (*buffer)[length - 1] == '\r') (*buffer)[--length] = '\0';
+            return *buffer;
+        }
+        // Riga più lunga del buffer: raddoppia e continua a leggere
+        if (length + 1 == *capacity) {
+            char *bigger = (char *) realloc(*buffer, *capacity * 2);
+            if (!bigger) return NULL;
+            *buffer = bigger;
+            *capacity *= 2;
+        }
+    }
+    // Ultima riga senza a capo
+    return length > 0 ? *buffer : NULL;
+}
+
+/**
+ * Legge le tessere di una mano, scritte come [a|b] (anche attaccate, "[1|2][3|3]") oppure come coppie di numeri
+ * separati da spazi ("1 2 3 3"). Qualsiasi altro carattere, una tessera scritta male o un numero senza il suo
+ * compagno rendono la riga non valida.
+ * @param line riga da leggere
+ * @param tiles array in cui salvare le tessere, grande almeno MAX_BATCH_TILES
+ * @param error puntatore in cui salvare il messaggio di errore
+ * @return numero di tessere lette, 0 se la riga va saltata, -1 se la mano non è valida
+ */
+int parseHandLine(const char *line, dominoTile *tiles, const char **error) {
+    /** Numero di tessere lette */
+    int numTiles = 0;
+    /** Numero di tessere normali lette */
+    int numNormals = 0;
+    /** Valori letti per la tessera attuale */
+    int numValues = 0;
+
+    while (*line == ' ' || *line == '\t') line++;
+    if (*line == '\0' || *line == '#') return 0;
+
+    while (*line) {
+        if (*line == ' ' || *line == '\t') {
+            line++;
+            continue;
+        }
+        if (numValues == 0 && numTiles == MAX_BATCH_TILES) {
+            *error = "troppe tessere";
+            return -1;
+        }
+        /** Se la tessera è scritta tra parentesi */
+        bool bracketed = *line == '[';
+        if (bracketed) {
+            // Una tessera tra parentesi non può completare due numeri scritti senza
+            if (numValues != 0) {
+                *error = "tessera incompleta";
+                return -1;
+            }
+            line++;
+            if (!readTileValue(&line, &tiles[numTiles].left) || *line++ != '|'
+                || !readTileValue(&line, &tiles[numTiles].right) || *line++ != ']') {
+                *error = "tessera scritta male, serve [a|b]";
+                return -1;
+            }
+            numValues = 2;
+        } else if (readTileValue(&line, numValues == 0 ? &tiles[numTiles].left : &tiles[numTiles].right)) {
+            numValues++;
+        } else {
+            *error = "carattere non valido";
+            return -1;
+        }
+        // Dopo un numero serve uno spazio, dopo una tessera tra parentesi può iniziarne subito un'altra
+        if (*line != '\0' && *line != ' ' && *line != '\t' && !(bracketed && *line == '[')) {
+            *error = "carattere non valido";
+            return -1;
+        }
+        if (numValues == 2) {
+            if (!isValidHandTile(tiles[numTiles])) {
+                *error = "tessera non valida";
+                return -1;
+            }
+            if (tiles[numTiles].left >= 1 && tiles[numTiles].left <= 6) numNormals++;
+            numTiles++;
+            numValues = 0;
+        }
+    }
+    if (numValues != 0) {
+        *error = "tessera incompleta";
+        return -1;
+    }
+    if (numNormals == 0) {
+        *error = "serve almeno una tessera normale";
+        return -1;
+    }
+    return numTiles;
+}
+
+/**
+ * Legge un numero di una tessera
+ * @param line puntatore alla posizione nella riga, spostato dopo il numero
+ * @param value puntatore in cui salvare il numero (al massimo 99: i numeri più grandi non sono comunque tessere valide)
+ * @return se nella posizione c'è un numero
+ */
+bool readTileValue(const char **line, int *value) {
+    if (**line < '0' || **line > '9') return false;
+    /** Numero letto */
+    long number = strtol(*line, (char **) line, 10);
+    *value = number > 99 ? 99 : (int) number;
+    return true;
+}
+
+/**
+ * Controlla se una tessera letta esiste: normale con numeri da 1 a 6 oppure speciale ([0|0], [11|11] o [12|21])
+ * @param tile tessera da controllare
+ * @return se la tessera è valida
+ */
+bool isValidHandTile(dominoTile tile) {
+    if (tile.left >= 1 && tile.left <= 6) return tile.right >= 1 && tile.right <= 6;
+    return (tile.left == 0 && tile.right == 0) || (tile.left == 11 && tile.right == 11) || (tile.left == 12 && tile.right == 21);
+}
+
+/**
+ * Stampa il risultato di una mano come riga JSON, ad esempio
+ * {"line":1,"tiles":3,"score":14,"board":["[1||2][2||3][3||3]"],"time_ms":0.054}
+ * con in più "optimal" se c'è un limite di tempo, "moves" (renderMoveListJSON) se sono richieste le mosse e "nodes" e
+ * "stats" (renderSearchStatsJSON) se sono richieste le statistiche. Con il formato OUTPUT_RLE o OUTPUT_JSON il campo
+ * è "rle" (renderBoardRLE) invece di "board". La riga viene costruita in un buffer e scritta con una sola chiamata.
+ * @param out file su cui stampare
+ * @param lineNumber numero della riga della mano
+ * @param numTiles numero di tessere della mano
+ * @param game migliore partita trovata
+ * @param timeUs microsecondi impiegati dalla ricerca
+ * @param context strutture della ricerca della mano
+ */
+void printBatchResult(FILE *out, long lineNumber, int numTiles, gameSituation *game, long long timeUs, aiContext *context) {
+    /** Riga JSON */
+    textBuffer buffer = createTextBuffer(TEXT_BUFFER_SIZE);
+    appendFormat(&buffer, "{\"line\":%ld,\"tiles\":%d,\"score\":%d,", lineNumber, numTiles, game->score);
+    if (context->options.outputFormat == OUTPUT_ASCII) {
+        appendText(&buffer, "\"board\":[");
+        for (int row = 0; row < game->rows; ++row) {
+            appendText(&buffer, row == 0 ? "\"" : ",\"");
+            renderBoardRow(&buffer, game, row, '{', '}');
+            appendText(&buffer, "\"");
+        }
+        appendText(&buffer, "]");
+    } else {
+        appendText(&buffer, "\"rle\":\"");
+        renderBoardRLE(&buffer, game);
+        appendText(&buffer, "\"");
+    }
+    appendFormat(&buffer, ",\"time_ms\":%.3f", timeUs / 1000.0);
+    if (context->options.budgetMs > 0) appendFormat(&buffer, ",\"optimal\":%s", context->timedOut ? "false" : "true");
+    if (context->options.printMoves) {
+        appendText(&buffer, ",\"moves\":");
+        renderMoveListJSON(&buffer, &context->bestMoves);
+    }
+    if (context->options.stats) {
+        appendFormat(&buffer, ",\"nodes\":%lld,\"stats\":", context->nodes);
+        renderSearchStatsJSON(&buffer, &threadStats, numTiles);
+    }
+    appendText(&buffer, "}\n");
+    writeTextBuffer(out, &buffer);
+    freeTextBuffer(&buffer);
+    // Chi legge l'output riceve ogni risultato appena è pronto
+    fflush(out);
+}
+
+/**
+ * Scrive le mosse di una partita come array JSON, una mossa per oggetto con la tessera, la cella (riga e colonna
+ * prima della mossa) della tessera in gioco a cui viene attaccata, l'orientamento ("H" o "V") e il lato ("L" o "R"):
+ * la prima tessera ha solo "tile"
+ * @param buffer buffer di testo
+ * @param moves mosse della partita
+ */
+void renderMoveListJSON(textBuffer *buffer, moveList *moves) {
+    appendText(buffer, "[");
+    for (int i = 0; i < moves->numMoves; ++i) {
+        /** Mossa da scrivere */
+        placedTile *move = &moves->moves[i];
+        appendFormat(buffer, "%s{\"tile\":\"[%d|%d]\"", i == 0 ? "" : ",", move->tile.left, move->tile.right);
+        if (move->isLinkedTo != NOT_VALID_CHAR)
+            appendFormat(buffer, ",\"row\":%d,\"col\":%d,\"orientation\":\"%c\",\"side\":\"%c\"",
+                         move->row, move->col, move->orientation, move->isLinkedTo);
+        appendText(buffer, "}");
+    }
+    appendText(buffer, "]");
+}
+
+/**
+ * Stampa come riga JSON l'errore di una riga che non contiene una mano valida
+ * @param out file su cui stampare
+ * @param lineNumber numero della riga
+ * @param error messaggio di errore
+ */
+void printBatchError(FILE *out, long lineNumber, const char *error) {
+    fprintf(out, "{\"line\":%ld,\"error\":\"%s\"}\n", lineNumber, error);
+    fflush(out);
+}
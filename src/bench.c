@@ -0,0 +1,131 @@
+/**
+ * @file bench.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente i benchmark della modalità AI: risolve mani sempre uguali (generate da un seme fisso)
+ * al variare del numero di tessere, del numero di speciali e del tipo di campo, e per ogni mano stampa una riga
+ * JSON con tempo, situazioni di gioco al secondo, allocazioni e memoria massima usata.
+ * @date 17/10/2026
+ */
+
+#include "bench.h"
+#include <sys/resource.h>
+
+/**
+ * Restituisce le mani di default del benchmark
+ * @return da 4 a 10 tessere, fino a 2 speciali, 5 mani per combinazione, seme 1, campo normale e su una sola fila
+ */
+benchConfig defaultBenchConfig(void) {
+    benchConfig config = {
+            .minTiles = 4,
+            .maxTiles = 10,
+            .maxSpecials = 2,
+            .hands = 5,
+            .seed = 1,
+            .mode = BENCH_BOTH,
+            .options = defaultAIOptions()
+    };
+    return config;
+}
+
+/**
+ * Risolve tutte le mani del benchmark e stampa una riga JSON per mano e una riga finale con i totali.
+ * Ogni mano ha la sua tabella delle trasposizioni, così il risultato non dipende dalle mani risolte prima.
+ * @param config mani da provare
+ * @param out file su cui stampare
+ */
+void runBenchmark(benchConfig config, FILE *out) {
+    /** Totali del benchmark */
+    benchTotals totals = {0, 0, 0, 0};
+
+    beginBoardPool();
+    for (int numTiles = config.minTiles; numTiles <= config.maxTiles; ++numTiles) {
+        for (int numSpecials = 0; numSpecials <= config.maxSpecials && numSpecials < numTiles; ++numSpecials) {
+            for (int hand = 0; hand < config.hands; ++hand) {
+                if (config.mode != BENCH_LINEAR) benchHand(out, &config, numTiles, numSpecials, true, hand, &totals);
+                if (config.mode != BENCH_PLANE) benchHand(out, &config, numTiles, numSpecials, false, hand, &totals);
+            }
+        }
+    }
+    endBoardPool();
+
+    fprintf(out, "{\"summary\":true,\"hands\":%d,\"nodes\":%lld,\"time_ms\":%.3f,\"nodes_per_sec\":%.0f,"
+                 "\"allocations\":%lld,\"peak_rss_kb\":%ld}\n",
+            totals.hands, totals.nodes, totals.timeUs / 1000.0,
+            totals.nodes * 1e6 / (totals.timeUs > 0 ? totals.timeUs : 1), totals.allocations, getPeakMemoryKb());
+}
+
+/**
+ * Risolve una mano del benchmark e stampa la sua riga JSON
+ * @param out file su cui stampare
+ * @param config mani da provare
+ * @param numTiles numero di tessere della mano
+ * @param numSpecials numero di tessere speciali della mano
+ * @param vertical se le tessere possono essere messe in verticale
+ * @param hand indice della mano tra quelle con lo stesso numero di tessere e di speciali
+ * @param totals totali del benchmark da aggiornare
+ */
+void benchHand(FILE *out, benchConfig *config, int numTiles, int numSpecials, bool vertical, int hand, benchTotals *totals) {
+    /** Seme della mano: la stessa mano viene provata sia sul campo normale sia su una sola fila */
+    unsigned long long seed = getHandSeed(config->seed, numTiles, numSpecials, hand);
+    /** Stato del generatore */
+    unsigned long long state = seed;
+    /** Tessere della mano */
+    dominoTile tiles[numTiles];
+    generateTilesSeeded(numTiles, numSpecials, tiles, &state);
+
+    /** Opzioni della ricerca */
+    aiOptions options = config->options;
+    options.vertical = vertical;
+    /** Strutture della ricerca, con una tabella delle trasposizioni vuota */
+    aiContext context = createAIContext(options);
+    /** Blocchi richiesti al pool prima della ricerca */
+    long long allocations = getBoardPoolAllocations();
+
+    /** Inizio della ricerca */
+    long long start = getTimeUs();
+    /** Migliore partita della mano */
+    gameSituation *bestGame = findBestGameAI(tiles, numTiles, &context);
+    /** Microsecondi impiegati dalla ricerca */
+    long long timeUs = getTimeUs() - start;
+    allocations = getBoardPoolAllocations() - allocations;
+
+    fprintf(out, "{\"tiles\":%d,\"specials\":%d,\"mode\":\"%s\",\"hand\":%d,\"seed\":%llu,\"score\":%d,\"nodes\":%lld,"
+                 "\"time_ms\":%.3f,\"nodes_per_sec\":%.0f,\"allocations\":%lld,\"peak_rss_kb\":%ld}\n",
+            numTiles, numSpecials, vertical ? "2d" : "linear", hand, seed, bestGame->score, context.nodes,
+            timeUs / 1000.0, context.nodes * 1e6 / (timeUs > 0 ? timeUs : 1), allocations, getPeakMemoryKb());
+    fflush(out);
+
+    totals->hands++;
+    totals->nodes += context.nodes;
+    totals->timeUs += timeUs;
+    totals->allocations += allocations;
+
+    freeGameSituation(bestGame);
+    freeAIContext(&context);
+    recycleBoardPool();
+}
+
+/**
+ * Calcola il seme di una mano: dipende solo dal seme del benchmark e dalla mano, non dalle altre mani provate
+ * @param seed seme del benchmark
+ * @param numTiles numero di tessere della mano
+ * @param numSpecials numero di tessere speciali della mano
+ * @param hand indice della mano
+ * @return seme della mano
+ */
+unsigned long long getHandSeed(unsigned long long seed, int numTiles, int numSpecials, int hand) {
+    /** Stato del generatore da cui viene preso il seme */
+    unsigned long long state = seed ^ ((unsigned long long) numTiles << 40) ^ ((unsigned long long) numSpecials << 32)
+                               ^ (unsigned long long) hand;
+    return ((unsigned long long) nextRandom(&state, 1 << 30) << 30) | (unsigned long long) nextRandom(&state, 1 << 30);
+}
+
+/**
+ * Restituisce la memoria massima usata dal processo fino a questo momento
+ * @return kilobyte (resident set size massimo)
+ */
+long getPeakMemoryKb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+    return usage.ru_maxrss;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file board_pool.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente il pool di memoria per le situazioni di gioco: durante una ricerca AI le matrici del
+ * campo e le situazioni di gioco vengono prese da blocchi grandi e riutilizzate, e alla fine vengono liberate tutte insieme.
+ * @date 17/10/2026
+ */
+
+#include "board_pool.h"
+
+/** Pool attivo del thread, usato da allocBoardMemory e freeBoardMemory quando depth > 0 */
+static THREAD_LOCAL boardPool activePool;
+
+/**
+ * Attiva il pool: da questo momento le situazioni di gioco vengono allocate nel pool fino alla endBoardPool
+ * corrispondente. Le chiamate possono essere annidate, il pool viene liberato dall'ultima endBoardPool.
+ */
+void beginBoardPool(void) {
+    if (activePool.depth == 0) activePool.allocations = 0;
+    activePool.depth++;
+}
+
+/**
+ * Chiude il pool: se è l'ultima beginBoardPool aperta libera tutti i blocchi grandi in un colpo solo.
+ * Tutte le situazioni di gioco allocate nel pool non devono più essere usate.
+ */
+void endBoardPool(void) {
+    if (activePool.depth == 0) return;
+    if (--activePool.depth > 0) return;
+    recycleBoardPool();
+    while (activePool.spareChunks) {
+        poolChunk *next = activePool.spareChunks->next;
+        free(activePool.spareChunks);
+        activePool.spareChunks = next;
+    }
+}
+
+/**
+ * Libera in un colpo solo tutte le situazioni di gioco allocate nel pool, che resta attivo: i blocchi grandi
+ * vengono tenuti per le allocazioni successive invece di essere restituiti al sistema
+ * (ad esempio tra una mano e l'altra della modalità batch).
+ */
+void recycleBoardPool(void) {
+    while (activePool.chunks) {
+        poolChunk *next = activePool.chunks->next;
+        // I blocchi più grandi di un blocco grande normale vengono liberati, servivano ad un solo blocco
+        if (activePool.chunks->size == POOL_CHUNK_SIZE) {
+            activePool.chunks->next = activePool.spareChunks;
+            activePool.spareChunks = activePool.chunks;
+        } else {
+            free(activePool.chunks);
+        }
+        activePool.chunks = next;
+    }
+    for (int i = 0; i < POOL_NUM_CLASSES; i++) activePool.freeLists[i] = NULL;
+    activePool.next = NULL;
+    activePool.left = 0;
+}
+
+/**
+ * Sospende il pool senza liberarlo: fino alla resumeBoardPool le situazioni di gioco vengono allocate con malloc
+ * (ad esempio per copiare un risultato che deve sopravvivere alla endBoardPool).
+ * @return numero di beginBoardPool aperte, da passare a resumeBoardPool
+ */
+int suspendBoardPool(void) {
+    int depth = activePool.depth;
+    activePool.depth = 0;
+    return depth;
+}
+
+/**
+ * Riattiva il pool sospeso da suspendBoardPool
+ * @param depth valore restituito da suspendBoardPool
+ */
+void resumeBoardPool(int depth) {
+    activePool.depth = depth;
+}
+
+/**
+ * Controlla se il pool è attivo
+ * @return se le allocazioni vengono fatte nel pool
+ */
+bool isBoardPoolActive(void) {
+    return activePool.depth > 0;
+}
+
+/**
+ * Restituisce il numero di blocchi richiesti al pool dall'ultima attivazione
+ * @return numero di allocazioni
+ */
+long long getBoardPoolAllocations(void) {
+    return activePool.allocations;
+}
+
+/**
+ * Alloca un nuovo blocco grande e lo aggiunge alla lista del pool
+ * @param bytes byte utilizzabili del blocco grande
+ * @return inizio della memoria utilizzabile oppure NULL se non c'è memoria
+ */
+char *allocPoolChunk(size_t bytes) {
+    /** Blocco grande da usare */
+    poolChunk *chunk;
+    if (bytes == POOL_CHUNK_SIZE && activePool.spareChunks) {
+        chunk = activePool.spareChunks;
+        activePool.spareChunks = chunk->next;
+    } else {
+        // L'intestazione del blocco grande occupa 16 byte per mantenere l'allineamento dei blocchi
+        chunk = (poolChunk *) malloc(bytes + 16);
+        if (!chunk) return NULL;
+        chunk->size = bytes;
+    }
+    chunk->next = activePool.chunks;
+    activePool.chunks = chunk;
+    return (char *) chunk + 16;
+}
+
+/**
+ * Alloca un blocco di memoria: nel pool se è attivo, altrimenti con malloc.
+ * @param bytes byte richiesti
+ * @return memoria allocata, da liberare con freeBoardMemory
+ */
+void *allocBoardMemory(size_t bytes) {
+    /** Classe di grandezza: il blocco intestazione compresa è la potenza di 2 successiva */
+    size_t sizeClass = POOL_MIN_CLASS;
+    while (((size_t) 1 << sizeClass) < bytes + sizeof(poolBlockHeader)) sizeClass++;
+    /** Grandezza del blocco intestazione compresa */
+    size_t blockSize = (size_t) 1 << sizeClass;
+    /** Intestazione del blocco allocato */
+    poolBlockHeader *header;
+
+    if (activePool.depth == 0 || sizeClass >= POOL_NUM_CLASSES) {
+        header = (poolBlockHeader *) malloc(bytes + sizeof(poolBlockHeader));
+        if (!header) return NULL;
+        header->pooled = false;
+    } else {
+        activePool.allocations++;
+        if (activePool.freeLists[sizeClass]) {
+            // Riusa un blocco della stessa classe liberato in precedenza
+            header = (poolBlockHeader *) activePool.freeLists[sizeClass];
+            activePool.freeLists[sizeClass] = *(void **) (header + 1);
+        } else if (blockSize > POOL_CHUNK_SIZE) {
+            // I blocchi più grandi di un blocco grande ne hanno uno tutto per loro
+            header = (poolBlockHeader *) allocPoolChunk(blockSize);
+            if (!header) return NULL;
+        } else {
+            if (activePool.left < blockSize) {
+                activePool.next = allocPoolChunk(POOL_CHUNK_SIZE);
+                if (!activePool.next) {
+                    activePool.left = 0;
+                    return NULL;
+                }
+                activePool.left = POOL_CHUNK_SIZE;
+            }
+            header = (poolBlockHeader *) activePool.next;
+            activePool.next += blockSize;
+            activePool.left -= blockSize;
+        }
+        header->pooled = true;
+    }
+    header->sizeClass = sizeClass;
+    return header + 1;
+}
+
+/**
+ * Libera un blocco di memoria allocato con allocBoardMemory: i blocchi del pool vengono tenuti per essere
+ * riutilizzati, gli altri vengono liberati con free.
+ * @param memory memoria da liberare (può essere NULL)
+ */
+void freeBoardMemory(void *memory) {
+    if (!memory) return;
+    /** Intestazione del blocco */
+    poolBlockHeader *header = (poolBlockHeader *) memory - 1;
+    if (header->pooled) {
+        *(void **) memory = activePool.freeLists[header->sizeClass];
+        activePool.freeLists[header->sizeClass] = header;
+    } else {
+        free(header);
+    }
+}
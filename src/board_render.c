@@ -0,0 +1,175 @@
+/**
+ * @file board_render.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la stampa del campo da gioco: il testo viene costruito in un buffer e scritto con una
+ * sola chiamata, come disegno (ogni cella è larga 3 caratteri) oppure con una codifica compatta run-length.
+ * @date 17/10/2026
+ */
+
+#include "board_render.h"
+
+/**
+ * Crea un buffer di testo vuoto
+ * @param capacity caratteri da allocare all'inizio (il buffer cresce quando serve)
+ * @returns buffer, da liberare con freeTextBuffer
+ */
+textBuffer createTextBuffer(size_t capacity) {
+    textBuffer buffer = {
+            .text = (char *) malloc(capacity + 1),
+            .length = 0,
+            .capacity = capacity
+    };
+    buffer.text[0] = '\0';
+    return buffer;
+}
+
+/**
+ * Libera un buffer di testo
+ * @param buffer buffer da liberare
+ */
+void freeTextBuffer(textBuffer *buffer) {
+    free(buffer->text);
+    buffer->text = NULL;
+    buffer->length = buffer->capacity = 0;
+}
+
+/**
+ * Aggiunge al buffer [length] caratteri da scrivere direttamente, ingrandendolo se serve
+ * @param buffer buffer di testo
+ * @param length caratteri da aggiungere
+ * @returns dove scrivere i caratteri aggiunti
+ */
+char *reserveText(textBuffer *buffer, size_t length) {
+    if (buffer->length + length > buffer->capacity) {
+        // Raddoppiando la capacità ogni carattere viene copiato in media una volta sola
+        while (buffer->length + length > buffer->capacity) buffer->capacity = 2 * buffer->capacity + 1;
+        buffer->text = (char *) realloc(buffer->text, buffer->capacity + 1);
+    }
+    /** Primo carattere aggiunto */
+    char *added = buffer->text + buffer->length;
+    buffer->length += length;
+    buffer->text[buffer->length] = '\0';
+    return added;
+}
+
+/**
+ * Aggiunge una stringa al buffer
+ * @param buffer buffer di testo
+ * @param text stringa da aggiungere
+ */
+void appendText(textBuffer *buffer, const char *text) {
+    /** Caratteri della stringa */
+    size_t length = strlen(text);
+    memcpy(reserveText(buffer, length), text, length);
+}
+
+/**
+ * Aggiunge al buffer un testo formattato come printf
+ * @param buffer buffer di testo
+ * @param format formato, come printf
+ */
+void appendFormat(textBuffer *buffer, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    /** Caratteri del testo formattato */
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (length <= 0) return;
+    /** Dove scrivere il testo: vsnprintf scrive anche '\0', che reserveText ha già messo dopo i caratteri */
+    char *added = reserveText(buffer, (size_t) length);
+    va_start(args, format);
+    vsnprintf(added, (size_t) length + 1, format, args);
+    va_end(args);
+}
+
+/**
+ * Scrive il contenuto del buffer con una sola chiamata e lo svuota
+ * @param out file su cui scrivere
+ * @param buffer buffer di testo
+ */
+void writeTextBuffer(FILE *out, textBuffer *buffer) {
+    fwrite(buffer->text, 1, buffer->length, out);
+    buffer->length = 0;
+    buffer->text[0] = '\0';
+}
+
+/**
+ * Disegna una riga del campo da gioco (senza andare a capo): [a|b] per le tessere orizzontali, 3 spazi per le celle
+ * vuote e per le tessere verticali il segno dato, i due punti e il valore. I valori vanno da 0 a 6, quindi ogni
+ * cella è larga 3 caratteri e la riga viene scritta direttamente nel buffer.
+ * @param buffer buffer di testo
+ * @param game situazione di gioco
+ * @param row riga da disegnare
+ * @param topMark carattere prima del lato in alto delle tessere verticali
+ * @param bottomMark carattere dopo il lato in basso delle tessere verticali
+ */
+void renderBoardRow(textBuffer *buffer, gameSituation *game, int row, char topMark, char bottomMark) {
+    /** Caratteri della riga */
+    char *out = reserveText(buffer, 3 * (size_t) game->cols);
+    for (int col = 0; col < game->cols; ++col, out += 3) {
+        /** Lato della tessera nella cella (l'orientamento dipende dal lato) */
+        char side = getCellSide(game->inGameDominoTiles[row][col]);
+        /** Valore della cella */
+        char digit = side == NOT_VALID_CHAR ? ' ' : (char) ('0' + getSideValue(game, row, col));
+        out[1] = digit;
+        if (side == LEFT) {
+            out[0] = '[';
+            out[2] = '|';
+        } else if (side == RIGHT) {
+            out[0] = '|';
+            out[2] = ']';
+        } else if (side == TOP) {
+            out[0] = topMark;
+            out[2] = ':';
+        } else if (side == BOTTOM) {
+            out[0] = ':';
+            out[2] = bottomMark;
+        } else {
+            out[0] = out[2] = ' ';
+        }
+    }
+}
+
+/**
+ * Disegna il campo da gioco della modalità AI, una riga di testo per ogni riga del campo: le tessere verticali sono
+ * {a: e :b}
+ * @param buffer buffer di testo
+ * @param game situazione di gioco
+ */
+void renderBoard(textBuffer *buffer, gameSituation *game) {
+    for (int row = 0; row < game->rows; ++row) {
+        renderBoardRow(buffer, game, row, '{', '}');
+        *reserveText(buffer, 1) = '\n';
+    }
+}
+
+/**
+ * Scrive il campo da gioco con una codifica compatta su una riga: "righe x colonne:" e poi le righe separate da '/'.
+ * In ogni riga una cella occupata è il lato della tessera (L, R, T o B) seguito dal valore, una serie di celle vuote
+ * è il loro numero seguito da '.', e le celle vuote alla fine della riga non vengono scritte.
+ * Ad esempio il campo con [1|2][2|3] e sotto al 3 la tessera verticale [3|4] è "2x5:L1R2L2R3T3/4.B4".
+ * @param buffer buffer di testo
+ * @param game situazione di gioco
+ */
+void renderBoardRLE(textBuffer *buffer, gameSituation *game) {
+    appendFormat(buffer, "%dx%d:", game->rows, game->cols);
+    for (int row = 0; row < game->rows; ++row) {
+        if (row > 0) *reserveText(buffer, 1) = '/';
+        /** Celle vuote incontrate dall'ultima cella occupata */
+        int emptyRun = 0;
+        for (int col = 0; col < game->cols; ++col) {
+            /** Lato della tessera nella cella */
+            char side = getCellSide(game->inGameDominoTiles[row][col]);
+            if (side == NOT_VALID_CHAR) {
+                emptyRun++;
+                continue;
+            }
+            if (emptyRun > 0) appendFormat(buffer, "%d.", emptyRun);
+            emptyRun = 0;
+            /** Lato e valore della cella */
+            char *out = reserveText(buffer, 2);
+            out[0] = side;
+            out[1] = (char) ('0' + getSideValue(game, row, col));
+        }
+    }
+}
@@ -7,6 +7,14 @@
  */
 
 #include "common_functions.h"
+#include "board_pool.h"
+#include <string.h>
+
+// Definizioni esterne delle funzioni inline di common_functions.h
+extern inline int getCellValue(dominoTileSide cell);
+extern inline char getCellSide(dominoTileSide cell);
+extern inline char getCellOrientation(dominoTileSide cell);
+extern inline dominoTileSide packCell(int value, char side);
 
 /**
  * Genera casualmente le tessere normali e speciali.
@@ -40,6 +48,53 @@ void generateTiles(int numTotalTiles, int numSpecials, dominoTile tilesOnHand[])
     }
 }
 
+/**
+ * Genera le tessere normali e speciali come generateTiles, ma con un generatore pseudo-casuale proprio invece di rand():
+ * lo stesso seme dà sempre le stesse tessere, su qualsiasi sistema (usato dai benchmark).
+ * @param numTotalTiles numero di tessere totali da generare
+ * @param numSpecials numero di tessere speciali da generare
+ * @param tilesOnHand array da riempire con le tessere generate
+ * @param seed stato del generatore, aggiornato ad ogni numero generato
+ */
+void generateTilesSeeded(int numTotalTiles, int numSpecials, dominoTile tilesOnHand[], unsigned long long *seed) {
+    // Tessere normali
+    for (int i = 0; i < numTotalTiles - numSpecials; i++) {
+        tilesOnHand[i].left = nextRandom(seed, 6) + 1;
+        // Il numero sul lato destro deve essere più grande o uguale a quello sul lato sinistro
+        tilesOnHand[i].right = nextRandom(seed, 7 - tilesOnHand[i].left) + tilesOnHand[i].left;
+    }
+
+    // Tessere speciali
+    for (int i = numTotalTiles - numSpecials; i < numTotalTiles; i++) {
+        switch (nextRandom(seed, 3)) {
+            case 0:
+                tilesOnHand[i].left = tilesOnHand[i].right = 0;
+                break;
+            case 1:
+                tilesOnHand[i].left = tilesOnHand[i].right = 11;
+                break;
+            case 2:
+                tilesOnHand[i].left = 12;
+                tilesOnHand[i].right = 21;
+                break;
+        }
+    }
+}
+
+/**
+ * Generatore pseudo-casuale splitmix64: avanza lo stato e restituisce un numero da 0 a bound - 1
+ * @param seed stato del generatore
+ * @param bound numero di valori possibili
+ * @return numero generato
+ */
+int nextRandom(unsigned long long *seed, int bound) {
+    unsigned long long z = (*seed += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (int) (z % (unsigned long long) bound);
+}
+
 /**
  * Stampa le tessere generate
  * @param numTiles numero di tessere generate
@@ -52,54 +107,92 @@ void printTiles(int numTiles, dominoTile tilesOnHand[]) {
 }
 
 /**
- * Sposta di [posMoved] colonne le tessere e mette le celle delle prime [posMoved] colonne a -1 (NOT_VALID_INT)
+ * Sposta di [posMoved] colonne le tessere e svuota le celle delle prime [posMoved] colonne (EMPTY_CELL).
+ * Se a sinistra della colonna 0 ci sono abbastanza colonne libere (leftCols) le celle restano dove sono: l'inizio di
+ * ogni riga si sposta di [posMoved] celle a sinistra, su celle già vuote.
  * @param game situazione di gioco le cui posizioni vanno spostate e le cui colonne sono state aggiornate
  * (a + posMoved) precedentemente, ma le ultime colonne sono vuote
  * @param posMoved numero di colonne da shiftare
+ * @return se è stato spostato l'inizio delle righe invece delle celle, da passare a moveLeft per annullare lo spostamento
 */
-void moveRight(gameSituation *game, int posMoved) {
+bool moveRight(gameSituation *game, int posMoved) {
+    if (game->leftCols >= posMoved) {
+        // Anche le righe non ancora usate, così tutte restano allineate
+        for (int row = 0; row < game->allocatedRows; ++row) game->inGameDominoTiles[row] -= posMoved;
+        game->leftCols -= posMoved;
+        return true;
+    }
     for (int row = 0; row < game->rows; ++row) {
-        /** Il nuovo indice, coincide con l'ultima colonna della matrice vuota */
-        int newIndex = game->cols - 1;
-        // La prima cella da spostare è l'ultima con un valore valido ossia l'ultima colonna prima
-        // di aver aggiornato le colonne
-        for (int cell = game->cols - posMoved - 1; cell >= 0; --cell) {
-            game->inGameDominoTiles[row][newIndex] = game->inGameDominoTiles[row][cell];
-            if (cell < posMoved) game->inGameDominoTiles[row][cell].value = NOT_VALID_INT;
-            newIndex--;
-        }
+        // Le celle da spostare sono quelle delle colonne prima di averle aggiornate
+        memmove(game->inGameDominoTiles[row] + posMoved, game->inGameDominoTiles[row], game->cols - posMoved);
+        memset(game->inGameDominoTiles[row], EMPTY_CELL, posMoved);
     }
+    return false;
+}
+
+/**
+ * Operazione inversa di moveRight: sposta di [posMoved] colonne a sinistra le tessere e svuota le ultime [posMoved] colonne.
+ * Se moveRight ha spostato l'inizio delle righe, l'inizio di ogni riga torna avanti di [posMoved] celle e le prime
+ * colonne tornano a sinistra della colonna 0, senza spostare le celle.
+ * @param game situazione di gioco le cui posizioni vanno spostate, con le colonne ancora da aggiornare (a - posMoved)
+ * e le prime [posMoved] colonne vuote
+ * @param posMoved numero di colonne da shiftare
+ * @param movedRowStarts valore restituito dalla moveRight da annullare
+*/
+void moveLeft(gameSituation *game, int posMoved, bool movedRowStarts) {
+    if (movedRowStarts) {
+        // Le celle dopo le colonne aggiornate sono vuote, come quelle mai usate del campo
+        for (int row = 0; row < game->allocatedRows; ++row) game->inGameDominoTiles[row] += posMoved;
+        game->leftCols += posMoved;
+        return;
+    }
+    for (int row = 0; row < game->rows; ++row) {
+        memmove(game->inGameDominoTiles[row], game->inGameDominoTiles[row] + posMoved, game->cols - posMoved);
+        memset(game->inGameDominoTiles[row] + game->cols - posMoved, EMPTY_CELL, posMoved);
+    }
+}
+
+/**
+ * Alloca un campo da gioco senza inizializzarlo: l'array delle righe e tutte le celle (un byte ciascuna) stanno in
+ * un unico blocco di memoria (preso dal pool se è attivo), le righe sono una dopo l'altra. Ogni riga ha [leftCols]
+ * celle allocate prima della colonna 0, per far crescere il campo a sinistra senza spostare le celle (moveRight).
+ * @param rows righe del campo da allocare
+ * @param cols colonne del campo da allocare
+ * @param leftCols colonne da allocare a sinistra della colonna 0
+ * @return newGame campo da gioco allocato
+*/
+dominoTileSide **allocInGameDominoTiles(int rows, int cols, int leftCols) {
+    dominoTileSide **newGame = (dominoTileSide **) allocBoardMemory(sizeof(dominoTileSide*) * rows + sizeof(dominoTileSide) * rows * (leftCols + cols));
+    /** Prima cella del campo, subito dopo l'array delle righe */
+    dominoTileSide *cells = (dominoTileSide *) (newGame + rows);
+    for (int row = 0; row < rows; row++) {
+        newGame[row] = cells + row * (leftCols + cols) + leftCols;
+    }
+    return newGame;
 }
 
 /**
  * Crea un campo da gioco mettendo valori di default
  * @param rows righe del campo da creare
  * @param cols colonne del campo da creare
+ * @param leftCols colonne da allocare a sinistra della colonna 0
  * @return newGame campo da gioco creato
 */
-dominoTileSide **createInGameDominoTiles(int rows, int cols) {
-    dominoTileSide **newGame = (dominoTileSide **) malloc(sizeof(dominoTileSide*) * rows);
-    for (int row = 0; row < rows; row++) {
-        newGame[row] = (dominoTileSide *) malloc(sizeof(dominoTileSide) * cols);
-        for (int cell = 0; cell < cols; cell++) {
-            newGame[row][cell].value = NOT_VALID_INT;
-            newGame[row][cell].side = NOT_VALID_CHAR;
-            newGame[row][cell].orientation = NOT_VALID_CHAR;
-        }
-    }
+dominoTileSide **createInGameDominoTiles(int rows, int cols, int leftCols) {
+    dominoTileSide **newGame = allocInGameDominoTiles(rows, cols, leftCols);
+    // Le righe sono una dopo l'altra: tutte le celle vengono svuotate insieme
+    if (rows > 0) memset(newGame[0] - leftCols, EMPTY_CELL, (size_t) rows * (leftCols + cols));
     return newGame;
 }
 
 /**
  * Libera la memoria allocata nell'heap per la matrice
  * @param dominoTilesInGame matrice del campo da gioco
- * @param rows righe della matrice
+ * @param rows righe della matrice (la matrice è un unico blocco, quindi non servono per liberarla)
 */
 void freeInGameDominoTiles(dominoTileSide **dominoTilesInGame, int rows) {
-    for (int row = 0; row < rows; row++) {
-        free(dominoTilesInGame[row]);
-    }
-    free(dominoTilesInGame);
+    (void) rows;
+    freeBoardMemory(dominoTilesInGame);
 }
 
 /**
@@ -128,52 +221,87 @@ void fixSpecialTiles(dominoTile *dominoTile, gameSituation *game, int row, int c
         case 11: // Caso tessera [11|11]
             for (int i = 0; i < game->rows; i++) {
                 for (int j = 0; j < game->cols; j++) {
-                    if (game->inGameDominoTiles[i][j].value != NOT_VALID_INT) { // Se la posizione del campo non è vuota
-                        if (game->inGameDominoTiles[i][j].value == 6) {
-                            game->inGameDominoTiles[i][j].value = 1; // Se la tessera contiene un 6, lo faccio diventare 1
+                    /** Cella del campo */
+                    dominoTileSide *cell = &game->inGameDominoTiles[i][j];
+                    if (getCellValue(*cell) != NOT_VALID_INT) { // Se la posizione del campo non è vuota
+                        if (getCellValue(*cell) == 6) {
+                            *cell = packCell(1, getCellSide(*cell)); // Se la tessera contiene un 6, lo faccio diventare 1
                             game->score -= 5; // Diminuisco score di 5
-                        } else if(game->inGameDominoTiles[i][j].value != 0) { // Lo zero non viene incrementato se no perde la sua abilità da speciale
-                            game->inGameDominoTiles[i][j].value++;
+                        } else if(getCellValue(*cell) != 0) { // Lo zero non viene incrementato se no perde la sua abilità da speciale
+                            *cell = packCell(getCellValue(*cell) + 1, getCellSide(*cell));
                             game->score++;
                         }
                     }
                 }
             }
             // Copio il valore della cella adiacente
-            dominoTile->left = dominoTile->right = game->inGameDominoTiles[row][col].value;
+            dominoTile->left = dominoTile->right = getSideValue(game, row, col);
             break;
 
         case 12: // Caso tessera [12|21]
-        if (game->inGameDominoTiles[row][col].orientation==HORIZONTAL) {
+        if (getCellOrientation(game->inGameDominoTiles[row][col])==HORIZONTAL) {
             if (isLinkedTo==RIGHT) { // Se tessera in mano si collega a dx di quella sul tavolo
-                dominoTile->left=game->inGameDominoTiles[row][col].value;
-                dominoTile->right=game->inGameDominoTiles[row][col-1].value;
+                dominoTile->left=getSideValue(game, row, col);
+                dominoTile->right=getSideValue(game, row, col-1);
             }
             else if (orientation==HORIZONTAL) { // Se tessera in mano collegata a sx e orizzontale
-                dominoTile->left=game->inGameDominoTiles[row][col+1].value;
-                dominoTile->right=game->inGameDominoTiles[row][col].value;
+                dominoTile->left=getSideValue(game, row, col+1);
+                dominoTile->right=getSideValue(game, row, col);
             } else { // Se tessera in mano collegata a sx e verticale
-                dominoTile->left=game->inGameDominoTiles[row][col].value;
-                dominoTile->right=game->inGameDominoTiles[row][col+1].value;
+                dominoTile->left=getSideValue(game, row, col);
+                dominoTile->right=getSideValue(game, row, col+1);
             }
         } else { // Se cella in campo proviene da una tessera verticale
             if (orientation==HORIZONTAL) { // Se tessera in mano orizzontale
                 if (isLinkedTo==LEFT) { // Se tessera in mano collegata a sx di quella in campo
-                    dominoTile->left=(game->inGameDominoTiles[row][col].side==TOP) ? game->inGameDominoTiles[row+1][col].value : game->inGameDominoTiles[row-1][col].value;
-                    dominoTile->right=game->inGameDominoTiles[row][col].value;
+                    dominoTile->left=(getCellSide(game->inGameDominoTiles[row][col])==TOP) ? getSideValue(game, row+1, col) : getSideValue(game, row-1, col);
+                    dominoTile->right=getSideValue(game, row, col);
                 } else { // Se tessera in mano collegata a dx di quella in campo
-                    dominoTile->left=game->inGameDominoTiles[row][col].value;
-                    dominoTile->right=(game->inGameDominoTiles[row][col].side==TOP) ? game->inGameDominoTiles[row+1][col].value : game->inGameDominoTiles[row-1][col].value;
+                    dominoTile->left=getSideValue(game, row, col);
+                    dominoTile->right=(getCellSide(game->inGameDominoTiles[row][col])==TOP) ? getSideValue(game, row+1, col) : getSideValue(game, row-1, col);
                 }
             } else { // Se tessera in mano verticale
-                dominoTile->left=game->inGameDominoTiles[row][col].value;
-                dominoTile->right=game->inGameDominoTiles[row-1][col].value;
+                dominoTile->left=getSideValue(game, row, col);
+                dominoTile->right=getSideValue(game, row-1, col);
             }
         }
         break;
     }
 }
 
+/**
+ * Restituisce il valore di una cella del campo, con le [11|11] non ancora applicate (lo 0 non viene incrementato)
+ * @param game situazione di gioco
+ * @param row riga della cella
+ * @param col colonna della cella
+ * @return valore della cella, NOT_VALID_INT se è vuota
+ */
+int getSideValue(gameSituation *game, int row, int col) {
+    return getActualValue(game, getCellValue(game->inGameDominoTiles[row][col]));
+}
+
+/**
+ * Restituisce il valore di un valore salvato in una cella, con le [11|11] non ancora applicate
+ * @param game situazione di gioco
+ * @param value valore salvato
+ * @return valore della cella
+ */
+int getActualValue(gameSituation *game, int value) {
+    if (value <= 0 || game->increments == 0) return value;
+    return (value - 1 + game->increments) % 6 + 1;
+}
+
+/**
+ * Restituisce il valore da salvare in una cella perché getSideValue restituisca quello dato
+ * @param game situazione di gioco
+ * @param value valore della cella
+ * @return valore da salvare
+ */
+int getStoredValue(gameSituation *game, int value) {
+    if (value <= 0 || game->increments == 0) return value;
+    return (value - 1 + 6 - game->increments) % 6 + 1;
+}
+
 /**
  * Controlla in base alla tessera adiacente se mettendo una tessera dalla mano,
  * la mossa è valida.
@@ -188,35 +316,37 @@ void fixSpecialTiles(dominoTile *dominoTile, gameSituation *game, int row, int c
 bool isValidMove(dominoTile tileToPut, gameSituation game, int rowTileInGame, int colTileInGame, char orientationTileToPut, char isLinkedTo) {
     /** Lato della tessera in gioco al quale sto cercando di collegare */
     dominoTileSide adjacent = game.inGameDominoTiles[rowTileInGame][colTileInGame];
+    /** Valore del lato della tessera in gioco */
+    int adjacentValue = getSideValue(&game, rowTileInGame, colTileInGame);
     // Controllo che la mossa implichi tessere speciali perchè queste possono essere collegate a prescindere
-    bool isSpecial = adjacent.value == 0 || tileToPut.left == 0 || tileToPut.left == 11 || tileToPut.left == 12;
+    bool isSpecial = adjacentValue == 0 || tileToPut.left == 0 || tileToPut.left == 11 || tileToPut.left == 12;
     if (orientationTileToPut == HORIZONTAL) { // Se sto mettendo in orizzontale
         if (isLinkedTo == LEFT) { // Se la sto mettendo alla sinistra dell'adiacente
-            if ((isSpecial && game.inGameDominoTiles[rowTileInGame][colTileInGame].value != NOT_VALID_INT) || tileToPut.right == adjacent.value) { // Se c'è adiacenza
+            if ((isSpecial && getCellValue(game.inGameDominoTiles[rowTileInGame][colTileInGame]) != NOT_VALID_INT) || tileToPut.right == adjacentValue) { // Se c'è adiacenza
                 if (colTileInGame == 0 // Bordo
-                    || (colTileInGame == 1 && game.inGameDominoTiles[rowTileInGame][colTileInGame - 1].value == NOT_VALID_INT) // Se sono una cella prima del bordo
-                    || (game.inGameDominoTiles[rowTileInGame][colTileInGame - 1].value == NOT_VALID_INT &&
-                        game.inGameDominoTiles[rowTileInGame][colTileInGame - 2].value == NOT_VALID_INT)) {
+                    || (colTileInGame == 1 && getCellValue(game.inGameDominoTiles[rowTileInGame][colTileInGame - 1]) == NOT_VALID_INT) // Se sono una cella prima del bordo
+                    || (getCellValue(game.inGameDominoTiles[rowTileInGame][colTileInGame - 1]) == NOT_VALID_INT &&
+                        getCellValue(game.inGameDominoTiles[rowTileInGame][colTileInGame - 2]) == NOT_VALID_INT)) {
                     return true;
                 }
             }
         } else if (isLinkedTo == RIGHT) { // Se la sto mettendo alla destra dell'adiacente
-            if ((isSpecial && game.inGameDominoTiles[rowTileInGame][colTileInGame].value != NOT_VALID_INT) || tileToPut.left == adjacent.value) { // Se c'è adiacenza
+            if ((isSpecial && getCellValue(game.inGameDominoTiles[rowTileInGame][colTileInGame]) != NOT_VALID_INT) || tileToPut.left == adjacentValue) { // Se c'è adiacenza
                 if (colTileInGame == game.cols - 1 // Bordo
                     || (colTileInGame == game.cols - 2 &&
-                        game.inGameDominoTiles[rowTileInGame][colTileInGame + 1].value == NOT_VALID_INT) // Se sono una cella prima del bordo
-                    || (game.inGameDominoTiles[rowTileInGame][colTileInGame + 1].value == NOT_VALID_INT &&
-                        game.inGameDominoTiles[rowTileInGame][colTileInGame + 2].value == NOT_VALID_INT)) {
+                        getCellValue(game.inGameDominoTiles[rowTileInGame][colTileInGame + 1]) == NOT_VALID_INT) // Se sono una cella prima del bordo
+                    || (getCellValue(game.inGameDominoTiles[rowTileInGame][colTileInGame + 1]) == NOT_VALID_INT &&
+                        getCellValue(game.inGameDominoTiles[rowTileInGame][colTileInGame + 2]) == NOT_VALID_INT)) {
                     return true;
                 }
             }
         }
     } else if (orientationTileToPut == VERTICAL) { // Se la sto mettendo in verticale
         if ((isLinkedTo == LEFT && colTileInGame == 0) || (colTileInGame == game.cols - 1 && isLinkedTo == RIGHT)) { // Le verticali possono essere attaccate solo ai bordi
-            if ((isSpecial && game.inGameDominoTiles[rowTileInGame][colTileInGame].value != NOT_VALID_INT) || tileToPut.left == adjacent.value) { // Se c'è adiacenza oppure speciale
+            if ((isSpecial && getCellValue(game.inGameDominoTiles[rowTileInGame][colTileInGame]) != NOT_VALID_INT) || tileToPut.left == adjacentValue) { // Se c'è adiacenza oppure speciale
                 // Le verticali possono essere attaccate alle orizzontali oppure ad altre verticali sul lato sotto
-                if (adjacent.orientation == HORIZONTAL ||
-                    (adjacent.orientation == VERTICAL && adjacent.side == BOTTOM)) {
+                if (getCellOrientation(adjacent) == HORIZONTAL ||
+                    (getCellOrientation(adjacent) == VERTICAL && getCellSide(adjacent) == BOTTOM)) {
                     return true;
                 }
             }
@@ -249,7 +379,7 @@ bool endGame(int numTotalTiles, dominoTile tilesOnHand[], gameSituation game) {
     // Controllo se ci sono combinazioni disponibili per continuare il gioco
     for (int row = 0; row < game.rows; row++) {
         for (int cell = 0; cell < game.cols; cell++) {
-            if (game.inGameDominoTiles[row][cell].value != NOT_VALID_INT) { // Se c'è una tessera in gioco valida
+            if (getCellValue(game.inGameDominoTiles[row][cell]) != NOT_VALID_INT) { // Se c'è una tessera in gioco valida
                 for (int onHandIndex = 0; onHandIndex < numTotalTiles; onHandIndex++) { //controllo se le tessere in mano hanno un numero da mettere sul tavolo
                     if (isValidMove(tilesOnHand[onHandIndex], game, row, cell, HORIZONTAL, LEFT)
                         || isValidMove(tilesOnHand[onHandIndex], game, row, cell, HORIZONTAL, RIGHT)
@@ -14,11 +14,15 @@
 */
 void playInteractive(int numTiles, dominoTile dominoTiles[]) {
     gameSituation game;
-    int numTotalTiles = numTiles;
-    game.inGameDominoTiles= createInGameDominoTiles(numTiles * 2, numTiles * 2); // Inizializzo il campo con il massimo di tessere che può contenere
+    int allocatedCols=2; // Colonne allocate del campo, che cresce con le tessere messe (reserveBoard)
+    game.inGameDominoTiles= createInGameDominoTiles(1, allocatedCols, 0); // Inizializzo il campo con lo spazio per la prima tessera
     game.rows=1;
     game.cols=2;
     game.score=0;
+    game.increments=0;
+    game.leftCols=0; // Nessuna colonna a sinistra: moveRight sposta le celle
+    game.maxLeftCols=0;
+    game.allocatedRows=1;
     do { // Fino a che non ho piu' carte da giocare
         printf("Il tuo punteggio e' di: %d\n", game.score);
         printf("Inserisci la posizione della tessera da mettere sul tavolo\n");
@@ -54,12 +58,12 @@ void playInteractive(int numTiles, dominoTile dominoTiles[]) {
         scanf("%c", &orientation);
         orientation=toupper(orientation);
 
-        if (game.inGameDominoTiles[row][col].orientation==VERTICAL) { // Se l'orientamento della tessera adiacente e' verticale
+        if (getCellOrientation(game.inGameDominoTiles[row][col])==VERTICAL) { // Se l'orientamento della tessera adiacente e' verticale
                 if (orientation==VERTICAL)  // Se l'orientamento della tessera che sto mettendo e' verticale
                     isLinkedTo = (col==0) ? LEFT : RIGHT; // Se sono sulla prima colonna si linka a sx, se e' sull'ultima si linka a dx
                  else { // Se l'orientamento della tessera che sto mettendo e' orizzontale
-                    if (col+1<game.cols && game.inGameDominoTiles[row][col+1].value!=NOT_VALID_INT) isLinkedTo=LEFT; // Se esiste col+1 e il posto successivo e' occupato, la tessera da mettere e' linkata a sx
-                    else if (col-1>=0 && game.inGameDominoTiles[row][col-1].value!=NOT_VALID_INT) isLinkedTo=RIGHT; //Se esiste col-1 e il posto successivo e' occupato, la tessera da mettere e' linkata a dx
+                    if (col+1<game.cols && getCellValue(game.inGameDominoTiles[row][col+1])!=NOT_VALID_INT) isLinkedTo=LEFT; // Se esiste col+1 e il posto successivo e' occupato, la tessera da mettere e' linkata a sx
+                    else if (col-1>=0 && getCellValue(game.inGameDominoTiles[row][col-1])!=NOT_VALID_INT) isLinkedTo=RIGHT; //Se esiste col-1 e il posto successivo e' occupato, la tessera da mettere e' linkata a dx
                     else { //Se posso scegliere da che parte linkarla
             printf("Vuoi collegare la tessera a sinistra o destra? (l=sinistra r=destra): ");
             while (isLinkedTo!='l' && isLinkedTo!='r')
@@ -68,9 +72,10 @@ void playInteractive(int numTiles, dominoTile dominoTiles[]) {
                 }
             }
         } else // Se l'orientamento della tessera adiacente e' orizzontale
-            isLinkedTo = (game.inGameDominoTiles[row][col].side==LEFT) ? LEFT : RIGHT; // Se la parte presa nel campo e' quella sx allora si colleghera' a sx, senno' viceversa
+            isLinkedTo = (getCellSide(game.inGameDominoTiles[row][col])==LEFT) ? LEFT : RIGHT; // Se la parte presa nel campo e' quella sx allora si colleghera' a sx, senno' viceversa
 
         if (isValidMove(dominoTiles[onHandIndex],game,row,col,orientation,isLinkedTo)) { // Se la mossa e' valida
+            reserveBoard(&game, &allocatedCols, game.rows+1, game.cols+2); // Una tessera aggiunge al massimo una riga e due colonne
             if (dominoTiles[onHandIndex].left==12 || dominoTiles[onHandIndex].left==11) {
                 fixSpecialTiles(dominoTiles+onHandIndex,&game,row,col,orientation,isLinkedTo);
                 }
@@ -105,22 +110,32 @@ void playInteractive(int numTiles, dominoTile dominoTiles[]) {
     while (!endGame(numTiles, dominoTiles, game));
 // Libero memoria e mostro punteggio
     //free(dominoTiles);
-    freeInGameDominoTiles(game.inGameDominoTiles, (numTotalTiles * 2));
+    freeInGameDominoTiles(game.inGameDominoTiles, game.allocatedRows);
     printf("partita finita! Il tuo punteggio e' di %d\n", game.score);
 }
 
 /**
- * Controlla se tra le tessere presenti ci sono speciali
- * @param tilesOnHand tessere in mano
- * @param numTotalTiles numero di tessere in mano
+ * Fa spazio nel campo da gioco per una mossa. Il campo è allocato grande quanto serve alle tessere messe finora:
+ * se la mossa ha bisogno di più righe o colonne viene riallocato con almeno il doppio dello spazio, copiando le
+ * tessere in gioco alle stesse coordinate.
+ * @param game situazione di gioco
+ * @param allocatedCols colonne allocate del campo, aggiornate se il campo viene riallocato
+ * @param rows righe che il campo deve poter contenere
+ * @param cols colonne che il campo deve poter contenere
  */
-bool hasSpecials(dominoTile tilesOnHand[], int numTotalTiles){
-    // Controllo se ci sono tessere speciali e se si allora sicuramente la partita non sarà finita
-    // perchè possono essere attaccate ovunque
-    for (int i = 0; i < numTotalTiles; i++) {
-        if (tilesOnHand[i].left == 0 || tilesOnHand[i].left == 12 || tilesOnHand[i].left == 11) return true;
-    }
-    return false;
+void reserveBoard(gameSituation *game, int *allocatedCols, int rows, int cols) {
+    if (rows <= game->allocatedRows && cols <= *allocatedCols) return;
+    /** Righe del nuovo campo */
+    int newRows = rows > game->allocatedRows ? (rows > 2 * game->allocatedRows ? rows : 2 * game->allocatedRows) : game->allocatedRows;
+    /** Colonne del nuovo campo */
+    int newCols = cols > *allocatedCols ? (cols > 2 * *allocatedCols ? cols : 2 * *allocatedCols) : *allocatedCols;
+    /** Nuovo campo, vuoto */
+    dominoTileSide **board = createInGameDominoTiles(newRows, newCols, 0);
+    for (int row = 0; row < game->rows; row++) memcpy(board[row], game->inGameDominoTiles[row], game->cols);
+    freeInGameDominoTiles(game->inGameDominoTiles, game->allocatedRows);
+    game->inGameDominoTiles = board;
+    game->allocatedRows = newRows;
+    *allocatedCols = newCols;
 }
 
 /**
@@ -150,17 +165,11 @@ int chooseTile(int numTiles) {
 
 void insertTile(gameSituation *game, dominoTile *dominoTileOnHand, dominoTile lastDominoTile,int row, int col, char orientation, int *numTiles) {
     if (orientation==HORIZONTAL) {
-        game->inGameDominoTiles[row][col].value=dominoTileOnHand->left;
-        game->inGameDominoTiles[row][col].side=LEFT;
-        game->inGameDominoTiles[row][col+1].value=dominoTileOnHand->right;
-        game->inGameDominoTiles[row][col+1].side=RIGHT;
-        game->inGameDominoTiles[row][col].orientation=game->inGameDominoTiles[row][col+1].orientation=HORIZONTAL;
+        game->inGameDominoTiles[row][col]=packCell(dominoTileOnHand->left, LEFT);
+        game->inGameDominoTiles[row][col+1]=packCell(dominoTileOnHand->right, RIGHT);
     } else {
-        game->inGameDominoTiles[row][col].value=dominoTileOnHand->left;
-        game->inGameDominoTiles[row][col].side=TOP;
-        game->inGameDominoTiles[row+1][col].value=dominoTileOnHand->right;
-        game->inGameDominoTiles[row+1][col].side=BOTTOM;
-        game->inGameDominoTiles[row][col].orientation=game->inGameDominoTiles[row+1][col].orientation=VERTICAL;
+        game->inGameDominoTiles[row][col]=packCell(dominoTileOnHand->left, TOP);
+        game->inGameDominoTiles[row+1][col]=packCell(dominoTileOnHand->right, BOTTOM);
     }
     game->score+=dominoTileOnHand->left + dominoTileOnHand->right;
     (*numTiles)--;
@@ -173,28 +182,17 @@ void insertTile(gameSituation *game, dominoTile *dominoTileOnHand, dominoTile la
 */
 
 void printTilesInGame(gameSituation game) {
-    printf("tessere sul tavolo:\n");
-    printf("   ");
-    for (int col=0; col<game.cols; col++) printf("%d  ",col);
-    printf("\n");
+    textBuffer buffer = createTextBuffer((size_t) (game.rows + 2) * (3 * game.cols + 16)); // Il campo viene scritto con una sola chiamata
+    appendText(&buffer, "tessere sul tavolo:\n");
+    appendText(&buffer, "   ");
+    for (int col=0; col<game.cols; col++) appendFormat(&buffer, "%d  ",col);
+    appendText(&buffer, "\n");
     for (int row=0; row<game.rows; row++)
     {
-        printf("%d ",row);
-        for (int col=0; col<game.cols; col++)
-        {
-            if (game.inGameDominoTiles[row][col].value!=NOT_VALID_INT)
-            {
-                if (game.inGameDominoTiles[row][col].side==LEFT)
-                    printf("[%d|", game.inGameDominoTiles[row][col].value);
-                else if (game.inGameDominoTiles[row][col].side==RIGHT)
-                    printf("|%d]", game.inGameDominoTiles[row][col].value);
-                    else if (game.inGameDominoTiles[row][col].side==TOP)
-                    printf("[%d:", game.inGameDominoTiles[row][col].value);
-                    else if (game.inGameDominoTiles[row][col].side==BOTTOM)
-                    printf(":%d]", game.inGameDominoTiles[row][col].value);
-            }
-            else printf("   ");
-        }
-        printf("\n");
+        appendFormat(&buffer, "%d ",row);
+        renderBoardRow(&buffer, &game, row, '[', ']'); // Le tessere verticali sono [a: e :b]
+        appendText(&buffer, "\n");
     }
+    writeTextBuffer(stdout, &buffer);
+    freeTextBuffer(&buffer);
 }
@@ -0,0 +1,219 @@
+/**
+ * @file iterative_ai.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la ricerca AI iterativa: le situazioni di gioco che la ricerca ricorsiva terrebbe sullo
+ * stack delle chiamate sono in uno stack allocato sullo heap, quindi la profondità non dipende dallo stack del thread
+ * e la ricerca può essere fermata dopo un certo numero di situazioni di gioco e ripresa, o annullata. Il risultato è
+ * lo stesso della ricerca ricorsiva (getBestGameAI), che usa le stesse funzioni per ogni situazione di gioco.
+ * @date 17/10/2026
+ */
+
+#include "iterative_ai.h"
+
+/**
+ * Trova la migliore partita come getBestGameAI, ma senza ricorsione
+ * @param hand tessere in mano, modificata durante la ricerca e ripristinata alla fine
+ * @param game situazione di gioco, con spazio per tutte le tessere
+ * @param toBeat punteggio da superare, NO_SCORE se qualsiasi situazione di gioco va bene
+ * @param context strutture condivise dalla ricerca
+ * @returns punteggio della migliore partita, le sue mosse sono in context->lines[hand->numTiles]; NO_SCORE se non
+ * si può superare toBeat
+ */
+int getBestGameIterative(tileHand *hand, gameSituation *game, int toBeat, aiContext *context){
+    /** Ricerca senza limite di situazioni di gioco */
+    iterativeSearch search = createIterativeSearch(hand, game, toBeat, context);
+    runIterativeSearch(&search, 0);
+    /** Punteggio della migliore partita */
+    int result = search.result;
+    freeIterativeSearch(&search);
+    return result;
+}
+
+/**
+ * Prepara una ricerca iterativa, che parte con runIterativeSearch
+ * @param hand tessere in mano
+ * @param game situazione di gioco, con spazio per tutte le tessere (le mosse vengono fatte direttamente su di essa)
+ * @param toBeat punteggio da superare, NO_SCORE se qualsiasi situazione di gioco va bene
+ * @param context strutture condivise dalla ricerca
+ * @returns ricerca, da liberare con freeIterativeSearch
+ */
+iterativeSearch createIterativeSearch(tileHand *hand, gameSituation *game, int toBeat, aiContext *context){
+    /** Lati di tessera già in gioco */
+    int sides = 0;
+    for (int value = 0; value <= 6; ++value) sides += context->counts.valueCounts[value];
+    /** Situazioni di gioco nello stack: una per ogni tessera in mano più quella iniziale */
+    int numFrames = hand->numTiles + 1;
+    iterativeSearch search = {
+            .hand = hand,
+            .game = game,
+            .context = context,
+            .frames = (searchFrame *) malloc(numFrames * sizeof(searchFrame)),
+            .depth = -1,
+            // Ogni tessera aggiunge due lati, ognuno è al più un'estremità
+            .maxSides = sides + 2 * hand->numTiles,
+            .result = NO_SCORE
+    };
+    search.points = (attachPoint *) malloc((search.maxSides + 1) * sizeof(attachPoint));
+    /** Mosse di tutte le situazioni di gioco: per ogni estremità al massimo 4 */
+    candidateMove *moves = (candidateMove *) malloc(numFrames * (4 * search.maxSides + 1) * sizeof(candidateMove));
+    for (int i = 0; i < numFrames; ++i) search.frames[i].moves = moves + i * (4 * search.maxSides + 1);
+    pushSearchFrame(&search, toBeat);
+    return search;
+}
+
+/**
+ * Continua una ricerca iterativa finché non finisce o non ha esplorato il numero di situazioni di gioco dato.
+ * Una ricerca ferma riprende da dove si era fermata chiamando di nuovo questa funzione.
+ * @param search ricerca creata con createIterativeSearch
+ * @param maxNodes situazioni di gioco da esplorare al massimo in questa chiamata, 0 per finire la ricerca
+ * @returns se la ricerca è finita (il risultato è in search->result)
+ */
+bool runIterativeSearch(iterativeSearch *search, long long maxNodes){
+    /** Strutture condivise dalla ricerca */
+    aiContext *context = search->context;
+    /** Situazioni di gioco esplorate prima di questa chiamata */
+    long long startNodes = context->nodes;
+    while (search->depth >= 0) {
+        /** Situazione di gioco in cima allo stack */
+        searchFrame *frame = &search->frames[search->depth];
+        if (frame->state == FRAME_ENTER) {
+            // La ricerca si ferma solo prima di una nuova situazione di gioco, quando le altre aspettano un risultato
+            if (maxNodes > 0 && context->nodes - startNodes >= maxNodes) return false;
+            if (!beginSearchNode(search->hand, search->game, frame->node.toBeat, context, &frame->node)) {
+                popSearchFrame(search, frame->node.best);
+                continue;
+            }
+            frame->state = FRAME_TYPES;
+            frame->typeIndex = 0;
+        }
+        // La prossima mossa porta in una nuova situazione di gioco, altrimenti sono state provate tutte
+        if (!nextSearchMove(search, frame)) {
+            endSearchNode(search->hand, search->game, context, &frame->node);
+            popSearchFrame(search, frame->node.best);
+        }
+    }
+    return true;
+}
+
+/**
+ * Libera una ricerca iterativa. Se non è finita viene annullata: le mosse ancora in gioco vengono tolte e le tessere
+ * tornano in mano, ma le mosse della migliore partita non sono complete e il risultato non è valido.
+ * @param search ricerca creata con createIterativeSearch
+ */
+void freeIterativeSearch(iterativeSearch *search){
+    // La situazione di gioco in cima allo stack non ha ancora fatto mosse, le altre aspettano il risultato della loro
+    for (int depth = search->depth - 1; depth >= 0; --depth) {
+        /** Situazione di gioco da cui è stata fatta la mossa */
+        searchFrame *frame = &search->frames[depth];
+        if (frame->state == FRAME_FIRST_CHILD) removeFirstTile(search->game, &search->context->counts);
+        else undoMove(search->game, &search->context->counts, &frame->undo);
+        addTileToHand(search->hand, frame->type);
+    }
+    search->depth = -1;
+    free(search->frames[0].moves);
+    free(search->frames);
+    free(search->points);
+    search->frames = NULL;
+    search->points = NULL;
+}
+
+/**
+ * Mette in cima allo stack la situazione di gioco raggiunta con l'ultima mossa fatta
+ * @param search ricerca iterativa
+ * @param toBeat punteggio che la situazione di gioco deve superare
+ */
+void pushSearchFrame(iterativeSearch *search, int toBeat){
+    /** Nuova situazione di gioco */
+    searchFrame *frame = &search->frames[++search->depth];
+    frame->state = FRAME_ENTER;
+    frame->node.toBeat = toBeat;
+}
+
+/**
+ * Toglie dallo stack la situazione di gioco in cima, che ha finito, e passa il suo risultato a quella precedente
+ * annullando la mossa che le collega, come al ritorno da getBestGameAI
+ * @param search ricerca iterativa
+ * @param score punteggio della migliore partita della situazione di gioco tolta, NO_SCORE se non supera il suo toBeat
+ */
+void popSearchFrame(iterativeSearch *search, int score){
+    if (--search->depth < 0) {
+        search->result = score;
+        return;
+    }
+    /** Situazione di gioco da cui è stata fatta la mossa */
+    searchFrame *frame = &search->frames[search->depth];
+    // Un punteggio restituito supera toBeat, quindi anche la migliore partita trovata finora
+    if (score != NO_SCORE) {
+        keepLine(search->context, search->hand);
+        frame->node.best = score;
+    }
+    if (frame->state == FRAME_FIRST_CHILD) {
+        removeFirstTile(search->game, &search->context->counts);
+        addTileToHand(search->hand, frame->type);
+        frame->state = FRAME_TYPES;
+    } else {
+        undoMove(search->game, &search->context->counts, &frame->undo);
+        frame->state = FRAME_MOVES;
+    }
+}
+
+/**
+ * Fa la prossima mossa valida di una situazione di gioco, nello stesso ordine di getBestGameAI, e mette in cima allo
+ * stack la situazione di gioco raggiunta
+ * @param search ricerca iterativa
+ * @param frame situazione di gioco in cima allo stack
+ * @returns se è stata fatta una mossa, false se sono state provate tutte
+ */
+bool nextSearchMove(iterativeSearch *search, searchFrame *frame){
+    /** Tessere in mano */
+    tileHand *hand = search->hand;
+    /** Situazione di gioco */
+    gameSituation *game = search->game;
+    /** Strutture condivise dalla ricerca */
+    aiContext *context = search->context;
+    while (true) {
+        if (frame->state == FRAME_MOVES) {
+            while (frame->moveIndex < frame->numMoves) {
+                /** Mossa da provare */
+                candidateMove *move = &frame->moves[frame->moveIndex++];
+                /** Tessera da inserire, girata se serve */
+                dominoTile tileToAdd = frame->tile;
+                if (!fitTile(&tileToAdd, *game, move->row, move->col, move->orientation, move->isLinkedTo)) continue;
+                recordMove(context, hand, tileToAdd, move->row, move->col, move->orientation, move->isLinkedTo);
+                makeMove(game, &context->counts, tileToAdd, move->row, move->col, move->orientation, move->isLinkedTo, &frame->undo);
+                frame->state = FRAME_MOVE_CHILD;
+                pushSearchFrame(search, scoreToBeat(frame->node.toBeat, frame->node.best));
+                return true;
+            }
+            addTileToHand(hand, frame->type);
+            frame->state = FRAME_TYPES;
+        }
+
+        // Ogni tipo di tessera in mano viene provato una volta sola, anche se ce ne sono più copie
+        frame->type = NOT_VALID_INT;
+        while (frame->typeIndex < NUM_TILE_TYPES && frame->type == NOT_VALID_INT) {
+            /** Tipo di tessera da provare */
+            int type = context->options.moveOrdering ? getOrderedType(frame->typeIndex) : frame->typeIndex;
+            frame->typeIndex++;
+            if (hand->counts[type] > 0) frame->type = type;
+        }
+        if (frame->type == NOT_VALID_INT) return false;
+        frame->tile = getTileOfType(frame->type);
+        removeTileFromHand(hand, frame->type);
+
+        // Se sono all'inizio della partita metto una tessera normale in orizzontale come prima tessera in gioco
+        if (game->score == 0 && !isSpecialType(frame->type)) {
+            placeFirstTile(game, &context->counts, frame->tile);
+            recordMove(context, hand, frame->tile, 0, 0, HORIZONTAL, NOT_VALID_CHAR);
+            frame->state = FRAME_FIRST_CHILD;
+            pushSearchFrame(search, scoreToBeat(frame->node.toBeat, frame->node.best));
+            return true;
+        }
+        /** Numero di estremità dei tratti di tessere in gioco */
+        int numPoints = getAttachPoints(*game, search->points);
+        frame->numMoves = getCandidateMoves(hand, frame->tile, game, frame->node.symmetric, context,
+                                            search->points, numPoints, frame->moves);
+        frame->moveIndex = 0;
+        frame->state = FRAME_MOVES;
+    }
+}
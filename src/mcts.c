@@ -0,0 +1,343 @@
+/**
+ * @file mcts.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la ricerca Monte Carlo (MCTS) per le mani troppo grandi per la ricerca completa: ogni
+ * playout scende nell'albero delle mosse già esplorate scegliendo con UCT, lo allarga di un livello e finisce la
+ * partita con mosse casuali. Le mosse valide sono le stesse della ricerca completa (getCandidateMoves, fitTile) e
+ * vengono fatte e annullate su un'unica situazione di gioco (makeMove, undoMove). Con più thread ogni thread fa
+ * crescere il suo albero e vince la migliore partita trovata. La partita non è dimostrata la migliore.
+ * @date 17/10/2026
+ */
+
+#include "mcts.h"
+
+/**
+ * Trova una buona partita con la ricerca Monte Carlo, dividendo i playout (context->options.mctsPlayouts) tra i
+ * thread (context->options.threads). Se c'è un limite di tempo i thread si fermano anche quando il tempo finisce.
+ * @param tilesOnHand tessere in mano (almeno una normale)
+ * @param numTilesOnHand numero di tessere
+ * @param context strutture della ricerca: alla fine contengono le mosse della partita trovata (context->bestMoves)
+ * e le situazioni di gioco esplorate
+ * @returns migliore partita trovata, da liberare con freeGameSituation
+ */
+gameSituation *getBestGameMCTS(dominoTile *tilesOnHand, int numTilesOnHand, aiContext *context) {
+    /** Opzioni della ricerca */
+    aiOptions options = context->options;
+    /** Numero di thread */
+    int numThreads = options.threads > 1 ? options.threads : 1;
+    /** Mosse della migliore partita di ogni thread */
+    placedTile *workerMoves = (placedTile *) malloc(numThreads * numTilesOnHand * sizeof(placedTile));
+    /** Dati dei thread */
+    mctsWorkerData *workers = (mctsWorkerData *) malloc(numThreads * sizeof(mctsWorkerData));
+    /** Thread avviati */
+    pthread_t *threads = (pthread_t *) malloc(numThreads * sizeof(pthread_t));
+    /** Se il thread è stato avviato (altrimenti il suo lavoro viene fatto da questo thread) */
+    bool *started = (bool *) malloc(numThreads * sizeof(bool));
+    for (int i = 0; i < numThreads; ++i) {
+        workers[i].tiles = tilesOnHand;
+        workers[i].numTiles = numTilesOnHand;
+        workers[i].options = options;
+        // Ogni thread ha i suoi numeri casuali, così gli alberi crescono in modo diverso
+        workers[i].seed = MCTS_SEED + (unsigned long long) i * 0x9E3779B97F4A7C15ULL;
+        workers[i].playouts = options.mctsPlayouts / numThreads + (i < options.mctsPlayouts % numThreads ? 1 : 0);
+        workers[i].deadline = context->deadline;
+        workers[i].best.moves = workerMoves + i * numTilesOnHand;
+        workers[i].best.numMoves = 0;
+        workers[i].best.score = NO_SCORE;
+        workers[i].nodes = 0;
+        started[i] = numThreads > 1 && pthread_create(&threads[i], NULL, mctsWorker, &workers[i]) == 0;
+        if (!started[i]) mctsWorker(&workers[i]);
+    }
+
+    /** Migliore partita tra quelle trovate dai thread, a parità di punteggio quella del primo thread */
+    moveList *best = NULL;
+    for (int i = 0; i < numThreads; ++i) {
+        if (started[i]) pthread_join(threads[i], NULL);
+        context->nodes += workers[i].nodes;
+        addSearchStats(&threadStats, &workers[i].stats);
+        if (!best || workers[i].best.score > best->score) best = &workers[i].best;
+    }
+    copyMoveList(&context->bestMoves, best);
+    // La ricerca non esplora tutte le partite: il risultato non è dimostrato il migliore
+    context->timedOut = true;
+
+    free(workerMoves);
+    free(workers);
+    free(threads);
+    free(started);
+    // Il campo della partita viene costruito una volta sola, rifacendo le sue mosse
+    return replayMoves(&context->bestMoves, numTilesOnHand);
+}
+
+/**
+ * Funzione eseguita da ogni thread: fa crescere un albero con i playout richiesti, o finché il tempo finisce, e
+ * tiene la migliore partita trovata
+ * @param data dati del thread (mctsWorkerData)
+ * @return NULL
+ */
+void *mctsWorker(void *data) {
+    /** Dati del thread */
+    mctsWorkerData *worker = (mctsWorkerData *) data;
+    /** Contatori del thread prima della ricerca, ripristinati alla fine se il lavoro viene fatto dal chiamante */
+    searchStats savedStats = threadStats;
+    beginBoardPool();
+    resetSearchStats(worker->options.stats);
+    /** Albero del thread */
+    mctsTree tree = createMCTSTree(worker->tiles, worker->numTiles, worker->options, worker->seed);
+    // Almeno un playout, così c'è sempre una partita
+    do {
+        runMCTSPlayout(&tree);
+    } while (tree.playouts < worker->playouts
+             && (worker->deadline == 0 || tree.playouts % MCTS_TIME_CHECK_INTERVAL != 0 || getTimeMs() < worker->deadline));
+
+    copyMoveList(&worker->best, &tree.best);
+    worker->nodes = tree.context.nodes;
+    worker->stats = threadStats;
+    freeMCTSTree(&tree);
+    endBoardPool();
+    threadStats = savedStats;
+    return NULL;
+}
+
+/**
+ * Crea l'albero di un thread, con la sola radice (la situazione di gioco vuota)
+ * @param tiles tessere in mano
+ * @param numTiles numero di tessere in mano
+ * @param options opzioni della ricerca
+ * @param seed seme dei numeri casuali
+ * @returns albero, da liberare con freeMCTSTree
+ */
+mctsTree createMCTSTree(dominoTile *tiles, int numTiles, aiOptions options, unsigned long long seed) {
+    // L'ordine delle mosse non serve: i playout le scelgono a caso
+    options.moveOrdering = false;
+    /** Lati di tessera in gioco al massimo, ognuno è al più un'estremità */
+    int maxSides = 2 * numTiles;
+    mctsTree tree = {
+            .context = {.options = options, .nodes = 0},
+            .hand = createTileHand(tiles, numTiles),
+            .game = {
+                    // Ogni tessera aggiunge al massimo una riga e due colonne, a destra o a sinistra
+                    .inGameDominoTiles = createInGameDominoTiles(numTiles + 1, 2 * numTiles + 2, 2 * numTiles),
+                    .rows = 1,
+                    .cols = 0,
+                    .score = 0,
+                    .leftCols = 2 * numTiles,
+                    .maxLeftCols = 2 * numTiles,
+                    .allocatedRows = numTiles + 1
+            },
+            .nodes = (mctsNode *) malloc(MCTS_INITIAL_NODES * sizeof(mctsNode)),
+            .numNodes = 1,
+            .capacity = MCTS_INITIAL_NODES,
+            .points = (attachPoint *) malloc((maxSides + 1) * sizeof(attachPoint)),
+            .candidates = (candidateMove *) malloc((4 * maxSides + 1) * sizeof(candidateMove)),
+            .moves = (mctsMove *) malloc(NUM_TILE_TYPES * (4 * maxSides + 1) * sizeof(mctsMove)),
+            .path = (mctsMove *) malloc((numTiles + 1) * sizeof(mctsMove)),
+            .undo = (undoRecord *) malloc((numTiles + 1) * sizeof(undoRecord)),
+            .depth = 0,
+            .visited = (int *) malloc((numTiles + 1) * sizeof(int)),
+            .numVisited = 0,
+            .seed = seed,
+            .best = {.moves = (placedTile *) malloc((numTiles + 1) * sizeof(placedTile)), .numMoves = 0, .score = NO_SCORE},
+            .playouts = 0
+    };
+    /** Radice: nessuna mossa */
+    mctsNode root = {.firstChild = NOT_VALID_INT, .numChildren = 0, .visits = 0, .totalScore = 0};
+    tree.nodes[0] = root;
+    return tree;
+}
+
+/**
+ * Libera un albero creato con createMCTSTree
+ * @param tree albero da liberare
+ */
+void freeMCTSTree(mctsTree *tree) {
+    freeInGameDominoTiles(tree->game.inGameDominoTiles, tree->game.allocatedRows);
+    free(tree->nodes);
+    free(tree->points);
+    free(tree->candidates);
+    free(tree->moves);
+    free(tree->path);
+    free(tree->undo);
+    free(tree->visited);
+    free(tree->best.moves);
+    tree->nodes = NULL;
+    tree->best.moves = NULL;
+}
+
+/**
+ * Fa un playout: scende nell'albero con selectMCTSChild, espande il nodo raggiunto e ne sceglie un figlio a caso,
+ * poi finisce la partita con mosse valide casuali. Il punteggio finale viene sommato ai nodi attraversati e alla
+ * fine tutte le mosse vengono annullate.
+ * @param tree albero del thread
+ */
+void runMCTSPlayout(mctsTree *tree) {
+    /** Nodo raggiunto */
+    int node = 0;
+    tree->numVisited = 0;
+    tree->visited[tree->numVisited++] = node;
+    while (tree->nodes[node].firstChild != NOT_VALID_INT && tree->nodes[node].numChildren > 0) {
+        node = selectMCTSChild(tree, node);
+        applyMCTSMove(tree, &tree->nodes[node].move);
+        tree->visited[tree->numVisited++] = node;
+    }
+    if (tree->nodes[node].firstChild == NOT_VALID_INT && expandMCTSNode(tree, node) && tree->nodes[node].numChildren > 0) {
+        node = tree->nodes[node].firstChild + nextRandom(&tree->seed, tree->nodes[node].numChildren);
+        applyMCTSMove(tree, &tree->nodes[node].move);
+        tree->visited[tree->numVisited++] = node;
+    }
+
+    // Fuori dall'albero le mosse sono casuali, fino alla fine della partita
+    /** Mosse valide della situazione di gioco */
+    int numMoves;
+    while ((numMoves = getMCTSMoves(tree)) > 0) applyMCTSMove(tree, &tree->moves[nextRandom(&tree->seed, numMoves)]);
+
+    /** Punteggio finale del playout */
+    int score = tree->game.score;
+    if (score > tree->best.score) {
+        for (int i = 0; i < tree->depth; ++i) tree->best.moves[i] = tree->path[i].move;
+        tree->best.numMoves = tree->depth;
+        tree->best.score = score;
+    }
+    for (int i = 0; i < tree->numVisited; ++i) {
+        tree->nodes[tree->visited[i]].visits++;
+        tree->nodes[tree->visited[i]].totalScore += score;
+    }
+    while (tree->depth > 0) undoMCTSMove(tree);
+    tree->playouts++;
+}
+
+/**
+ * Sceglie con UCT il figlio di un nodo espanso da cui far passare il playout: prima i figli mai visitati, poi quello
+ * con il punteggio medio (diviso per il migliore trovato, così sta tra 0 e 1) più alto, aumentato per i figli
+ * visitati poche volte rispetto al padre
+ * @param tree albero del thread
+ * @param nodeIndex nodo espanso con almeno un figlio
+ * @returns indice del figlio scelto
+ */
+int selectMCTSChild(mctsTree *tree, int nodeIndex) {
+    /** Nodo padre */
+    mctsNode *parent = &tree->nodes[nodeIndex];
+    /** Logaritmo delle visite del padre */
+    double logVisits = log((double) parent->visits);
+    /** Figlio scelto */
+    int bestChild = parent->firstChild;
+    /** Valore UCT del figlio scelto */
+    double bestValue = -1;
+    for (int child = parent->firstChild; child < parent->firstChild + parent->numChildren; ++child) {
+        /** Figlio */
+        mctsNode *node = &tree->nodes[child];
+        if (node->visits == 0) return child;
+        /** Valore UCT del figlio */
+        double value = node->totalScore / node->visits / tree->best.score
+                       + MCTS_EXPLORATION * sqrt(logVisits / node->visits);
+        if (value > bestValue) {
+            bestValue = value;
+            bestChild = child;
+        }
+    }
+    return bestChild;
+}
+
+/**
+ * Espande un nodo: aggiunge all'albero un figlio per ogni mossa valida della situazione di gioco attuale, che deve
+ * essere quella del nodo
+ * @param tree albero del thread
+ * @param nodeIndex nodo da espandere
+ * @returns se il nodo è stato espanso, false se l'albero è pieno (MCTS_MAX_NODES)
+ */
+bool expandMCTSNode(mctsTree *tree, int nodeIndex) {
+    /** Mosse valide */
+    int numMoves = getMCTSMoves(tree);
+    if (tree->numNodes + numMoves > MCTS_MAX_NODES) return false;
+    if (tree->numNodes + numMoves > tree->capacity) {
+        while (tree->numNodes + numMoves > tree->capacity) tree->capacity *= 2;
+        tree->nodes = (mctsNode *) realloc(tree->nodes, tree->capacity * sizeof(mctsNode));
+    }
+    tree->nodes[nodeIndex].firstChild = tree->numNodes;
+    tree->nodes[nodeIndex].numChildren = numMoves;
+    for (int i = 0; i < numMoves; ++i) {
+        /** Nuovo figlio */
+        mctsNode *child = &tree->nodes[tree->numNodes++];
+        child->move = tree->moves[i];
+        child->firstChild = NOT_VALID_INT;
+        child->numChildren = 0;
+        child->visits = 0;
+        child->totalScore = 0;
+    }
+    return true;
+}
+
+/**
+ * Prepara le mosse valide della situazione di gioco attuale in tree->moves: ogni tipo di tessera in mano una volta
+ * sola, in ogni posizione di getCandidateMoves in cui entra (girata se serve, come nella ricerca completa).
+ * All'inizio della partita la prima tessera è una tessera normale in orizzontale.
+ * @param tree albero del thread
+ * @returns numero di mosse valide, 0 se la partita è finita
+ */
+int getMCTSMoves(mctsTree *tree) {
+    /** Situazione di gioco */
+    gameSituation *game = &tree->game;
+    /** Numero di mosse valide */
+    int numMoves = 0;
+    /** Numero di estremità dei tratti di tessere in gioco */
+    int numPoints = game->score == 0 ? 0 : getAttachPoints(*game, tree->points);
+    for (int type = 0; type < NUM_TILE_TYPES; ++type) {
+        if (tree->hand.counts[type] == 0) continue;
+        /** Tessera del tipo */
+        dominoTile tile = getTileOfType(type);
+        if (game->score == 0) {
+            if (isSpecialType(type)) continue;
+            mctsMove first = {.move = {.tile = tile, .row = 0, .col = 0, .orientation = HORIZONTAL, .isLinkedTo = NOT_VALID_CHAR}, .type = type};
+            tree->moves[numMoves++] = first;
+            continue;
+        }
+        /** Posizioni da provare */
+        int numCandidates = getCandidateMoves(&tree->hand, tile, game, false, &tree->context, tree->points, numPoints, tree->candidates);
+        for (int i = 0; i < numCandidates; ++i) {
+            /** Posizione da provare */
+            candidateMove *candidate = &tree->candidates[i];
+            /** Tessera girata se serve */
+            dominoTile fitted = tile;
+            if (!fitTile(&fitted, *game, candidate->row, candidate->col, candidate->orientation, candidate->isLinkedTo)) continue;
+            mctsMove move = {
+                    .move = {.tile = fitted, .row = candidate->row, .col = candidate->col,
+                             .orientation = candidate->orientation, .isLinkedTo = candidate->isLinkedTo},
+                    .type = type
+            };
+            tree->moves[numMoves++] = move;
+        }
+    }
+    return numMoves;
+}
+
+/**
+ * Fa una mossa sulla situazione di gioco dell'albero e la aggiunge al percorso
+ * @param tree albero del thread
+ * @param move mossa valida nella situazione di gioco attuale
+ */
+void applyMCTSMove(mctsTree *tree, mctsMove *move) {
+    /** Tessera e posizione */
+    placedTile *placed = &move->move;
+    removeTileFromHand(&tree->hand, move->type);
+    if (placed->isLinkedTo == NOT_VALID_CHAR)
+        placeFirstTile(&tree->game, &tree->context.counts, placed->tile);
+    else
+        makeMove(&tree->game, &tree->context.counts, placed->tile, placed->row, placed->col, placed->orientation, placed->isLinkedTo, &tree->undo[tree->depth]);
+    tree->path[tree->depth++] = *move;
+    tree->context.nodes++;
+    countNode(tree->hand.numTiles);
+}
+
+/**
+ * Annulla l'ultima mossa del percorso e rimette la tessera in mano
+ * @param tree albero del thread, con almeno una mossa fatta
+ */
+void undoMCTSMove(mctsTree *tree) {
+    /** Mossa da annullare */
+    mctsMove *move = &tree->path[--tree->depth];
+    if (move->move.isLinkedTo == NOT_VALID_CHAR)
+        removeFirstTile(&tree->game, &tree->context.counts);
+    else
+        undoMove(&tree->game, &tree->context.counts, &tree->undo[tree->depth]);
+    addTileToHand(&tree->hand, move->type);
+}
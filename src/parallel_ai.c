@@ -0,0 +1,336 @@
+/**
+ * @file parallel_ai.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la ricerca AI su più thread: i sottoproblemi dopo le prime mosse vengono divisi tra
+ * i thread, che si rubano il lavoro a vicenda e condividono il punteggio della migliore partita trovata.
+ * @date 17/10/2026
+ */
+
+#include "parallel_ai.h"
+
+/**
+ * Cerca la migliore situazione di gioco dividendo la ricerca tra più thread. Il risultato è lo stesso della ricerca
+ * su un solo thread: a parità di punteggio vince la partita del sottoproblema che verrebbe esplorato prima.
+ * @param hand tessere generate
+ * @param defaultGame situazione di gioco iniziale
+ * @param context strutture condivise dalla ricerca (context->options.threads è il numero di thread)
+ * @return punteggio della migliore partita, le sue mosse sono in context->lines[hand->numTiles]
+ */
+int getBestGameParallel(tileHand *hand, gameSituation *defaultGame, aiContext *context) {
+    /** Sottoproblemi da dividere tra i thread */
+    aiTaskList taskList = {.tasks = NULL, .numTasks = 0, .capacity = 0, .splitAt = 0};
+    /** Numero di thread richiesti */
+    int numThreads = context->options.threads;
+    // Ci si ferma dopo 2 mosse, o dopo 3 se i sottoproblemi sono troppo pochi per tenere occupati i thread
+    for (int depth = 2; depth <= MAX_SPLIT_DEPTH; ++depth) {
+        freeTaskList(&taskList);
+        taskList.splitAt = hand->numTiles - depth;
+        collectTasks(hand, defaultGame, context, &taskList);
+        if (taskList.numTasks >= MIN_TASKS_PER_THREAD * numThreads) break;
+    }
+    if (taskList.numTasks == 0) {
+        freeTaskList(&taskList);
+        return searchBestGame(hand, defaultGame, NO_SCORE, context);
+    }
+
+    /** Dati condivisi dai thread */
+    parallelSearch search = {
+            .taskList = &taskList,
+            .numWorkers = numThreads < taskList.numTasks ? numThreads : taskList.numTasks,
+            .best = {.packed = packBestScore(NO_SCORE, taskList.numTasks)},
+            .options = context->options,
+            .allocatedRows = hand->numTiles + 1,
+            .allocatedCols = 2 * hand->numTiles + 2,
+            .tableSizeLog2 = DEFAULT_TABLE_SIZE_LOG2,
+            .deadline = context->deadline,
+            .tablebase = context->tablebase,
+            .numTiles = context->numTiles
+    };
+    // La memoria per le tabelle delle trasposizioni viene divisa tra i thread
+    for (int i = 1; i < search.numWorkers && search.tableSizeLog2 > MIN_TABLE_SIZE_LOG2; i *= 2) search.tableSizeLog2--;
+
+    // I sottoproblemi vengono distribuiti a turno, così ogni thread inizia da quelli che verrebbero esplorati prima
+    search.queues = (workerQueue *) malloc(search.numWorkers * sizeof(workerQueue));
+    for (int i = 0; i < search.numWorkers; ++i) {
+        search.queues[i].taskIndexes = (int *) malloc((taskList.numTasks / search.numWorkers + 1) * sizeof(int));
+        search.queues[i].head = search.queues[i].tail = 0;
+        pthread_mutex_init(&search.queues[i].lock, NULL);
+    }
+    for (int i = 0; i < taskList.numTasks; ++i) {
+        workerQueue *queue = &search.queues[i % search.numWorkers];
+        queue->taskIndexes[queue->tail++] = i;
+    }
+
+    /** Mosse della migliore partita di ogni thread */
+    placedTile *workerMoves = (placedTile *) malloc(search.numWorkers * context->numTiles * sizeof(placedTile));
+    /** Dati dei thread */
+    workerData *workers = (workerData *) malloc(search.numWorkers * sizeof(workerData));
+    /** Thread avviati */
+    pthread_t *threads = (pthread_t *) malloc(search.numWorkers * sizeof(pthread_t));
+    /** Se il thread è stato avviato (altrimenti il suo lavoro viene fatto da questo thread) */
+    bool *started = (bool *) malloc(search.numWorkers * sizeof(bool));
+    for (int i = 0; i < search.numWorkers; ++i) {
+        workers[i].search = &search;
+        workers[i].id = i;
+        workers[i].best.moves = workerMoves + i * context->numTiles;
+        workers[i].best.numMoves = 0;
+        workers[i].best.score = NO_SCORE;
+        workers[i].bestIndex = taskList.numTasks;
+        workers[i].nodes = 0;
+        workers[i].timedOut = false;
+        started[i] = pthread_create(&threads[i], NULL, searchWorker, &workers[i]) == 0;
+        if (!started[i]) searchWorker(&workers[i]);
+    }
+
+    /** Migliore partita tra quelle trovate dai thread */
+    moveList *best = NULL;
+    /** Indice del sottoproblema della migliore partita */
+    int bestIndex = taskList.numTasks;
+    for (int i = 0; i < search.numWorkers; ++i) {
+        if (started[i]) pthread_join(threads[i], NULL);
+        context->nodes += workers[i].nodes;
+        addSearchStats(&threadStats, &workers[i].stats);
+        if (workers[i].timedOut) context->timedOut = true;
+        if (workers[i].best.score != NO_SCORE
+            && (!best || isBetterResult(workers[i].best.score, workers[i].bestIndex, best->score, bestIndex))) {
+            best = &workers[i].best;
+            bestIndex = workers[i].bestIndex;
+        }
+    }
+    /** Punteggio della migliore partita */
+    int bestScore = best ? best->score : NO_SCORE;
+    if (best) copyMoveList(&context->lines[hand->numTiles], best);
+
+    for (int i = 0; i < search.numWorkers; ++i) {
+        pthread_mutex_destroy(&search.queues[i].lock);
+        free(search.queues[i].taskIndexes);
+    }
+    free(search.queues);
+    free(workerMoves);
+    free(workers);
+    free(threads);
+    free(started);
+    freeTaskList(&taskList);
+    return bestScore;
+}
+
+/**
+ * Raccoglie i sottoproblemi della ricerca parallela: esplora le prime mosse come la ricerca su un solo thread
+ * (senza pruning né tabella delle trasposizioni) e salva le situazioni di gioco con taskList->splitAt tessere in mano.
+ * @param hand tessere generate
+ * @param defaultGame situazione di gioco iniziale
+ * @param context strutture condivise dalla ricerca
+ * @param taskList lista in cui salvare i sottoproblemi
+ */
+void collectTasks(tileHand *hand, gameSituation *defaultGame, aiContext *context, aiTaskList *taskList) {
+    /** Strutture della ricerca che raccoglie i sottoproblemi */
+    aiContext collector = *context;
+    collector.table = NULL;
+    collector.options.pruning = false;
+    collector.tasks = taskList;
+    collector.deadline = 0;
+    searchBestGame(hand, defaultGame, NO_SCORE, &collector);
+    context->nodes += collector.nodes;
+}
+
+/**
+ * Aggiunge un sottoproblema alla lista, copiando situazione di gioco, tessere in mano e mosse fatte
+ * @param taskList lista dei sottoproblemi
+ * @param hand tessere in mano
+ * @param game situazione di gioco
+ * @param counts contatori del campo della situazione di gioco
+ * @param path mosse fatte dall'inizio della partita
+ * @param numMoves numero di mosse fatte
+ */
+void addTask(aiTaskList *taskList, tileHand *hand, gameSituation game, boardCounts *counts, placedTile *path, int numMoves) {
+    if (taskList->numTasks == taskList->capacity) {
+        taskList->capacity = taskList->capacity ? 2 * taskList->capacity : 64;
+        taskList->tasks = (aiTask *) realloc(taskList->tasks, taskList->capacity * sizeof(aiTask));
+    }
+    /** Sottoproblema aggiunto */
+    aiTask *task = &taskList->tasks[taskList->numTasks++];
+    task->game = copyGame(game, NOT_VALID_CHAR, NOT_VALID_INT);
+    task->counts = *counts;
+    task->hand = *hand;
+    task->moves.moves = (placedTile *) malloc(numMoves * sizeof(placedTile));
+    memcpy(task->moves.moves, path, numMoves * sizeof(placedTile));
+    task->moves.numMoves = numMoves;
+    task->moves.score = NO_SCORE;
+}
+
+/**
+ * Libera i sottoproblemi della lista e la svuota
+ * @param taskList lista dei sottoproblemi
+ */
+void freeTaskList(aiTaskList *taskList) {
+    for (int i = 0; i < taskList->numTasks; ++i) {
+        freeGameSituation(taskList->tasks[i].game);
+        free(taskList->tasks[i].moves.moves);
+    }
+    free(taskList->tasks);
+    taskList->tasks = NULL;
+    taskList->numTasks = taskList->capacity = 0;
+}
+
+/**
+ * Restituisce il prossimo sottoproblema per un thread: il primo della sua coda oppure, se è vuota,
+ * l'ultimo della coda di un altro thread.
+ * @param search dati condivisi dai thread
+ * @param id indice del thread
+ * @return indice del sottoproblema, -1 se non ce ne sono più
+ */
+int nextTask(parallelSearch *search, int id) {
+    for (int i = 0; i < search->numWorkers; ++i) {
+        /** Coda da cui prendere il sottoproblema */
+        workerQueue *queue = &search->queues[(id + i) % search->numWorkers];
+        /** Sottoproblema preso */
+        int taskIndex = -1;
+        pthread_mutex_lock(&queue->lock);
+        if (queue->head < queue->tail)
+            taskIndex = i == 0 ? queue->taskIndexes[queue->head++] : queue->taskIndexes[--queue->tail];
+        pthread_mutex_unlock(&queue->lock);
+        if (taskIndex >= 0) return taskIndex;
+    }
+    return -1;
+}
+
+/**
+ * Funzione eseguita da ogni thread: risolve sottoproblemi finché ce ne sono, con un pool e una tabella delle
+ * trasposizioni propri, e tiene la migliore situazione di gioco trovata.
+ * @param data dati del thread (workerData)
+ * @return NULL
+ */
+void *searchWorker(void *data) {
+    /** Dati del thread */
+    workerData *worker = (workerData *) data;
+    /** Dati condivisi dai thread */
+    parallelSearch *search = worker->search;
+    beginBoardPool();
+    resetSearchStats(search->options.stats);
+    /** Strutture della ricerca del thread */
+    aiContext context = {
+            .table = createTranspositionTable(search->tableSizeLog2),
+            .tablebase = search->tablebase,
+            .options = search->options,
+            .bestScore = NO_SCORE,
+            .nodes = 0,
+            .shared = &search->best,
+            .taskIndex = 0,
+            .tasks = NULL,
+            .deadline = search->deadline,
+            .timedOut = false,
+            .incumbent = {.moves = NULL, .numMoves = 0, .score = NO_SCORE},
+            .path = NULL,
+            .lines = NULL,
+            .bestMoves = {.moves = NULL, .numMoves = 0, .score = NO_SCORE}
+    };
+    allocMoveLists(&context, search->numTiles);
+
+    /** Sottoproblema da risolvere */
+    int taskIndex;
+    while ((taskIndex = nextTask(search, worker->id)) >= 0) {
+        /** Sottoproblema da risolvere */
+        aiTask *task = &search->taskList->tasks[taskIndex];
+        context.taskIndex = taskIndex;
+        /** Situazione di gioco del sottoproblema: se le mosse vengono fatte su di essa deve poter contenere tutte le tessere */
+        gameSituation game = *task->game;
+        if (search->options.inPlace || search->options.iterative) {
+            // Ogni tessera ancora in mano fa crescere il campo a sinistra al massimo di 2 colonne
+            game.leftCols = game.maxLeftCols = 2 * task->hand.numTiles;
+            game.allocatedRows = search->allocatedRows;
+            game.inGameDominoTiles = copyMatrixSides(*task->game, search->allocatedRows, search->allocatedCols, game.leftCols);
+        } else {
+            game.leftCols = game.maxLeftCols = COPY_LEFT_COLS;
+            game.allocatedRows = task->game->rows;
+            game.inGameDominoTiles = copyMatrixSides(*task->game, task->game->rows, task->game->cols, COPY_LEFT_COLS);
+        }
+        context.counts = task->counts;
+        /** Tessere in mano del sottoproblema */
+        tileHand hand = task->hand;
+        // Le mosse trovate dalla ricerca continuano quelle fatte per arrivare al sottoproblema
+        memcpy(context.path, task->moves.moves, task->moves.numMoves * sizeof(placedTile));
+
+        // Se il tempo è finito il risultato della ricerca interrotta non è affidabile
+        if (searchBestGame(&hand, &game, NO_SCORE, &context) != NO_SCORE && !context.timedOut)
+            keepBetterResult(worker, &context.lines[hand.numTiles], taskIndex);
+        freeInGameDominoTiles(game.inGameDominoTiles, game.rows);
+        // La migliore partita finita del sottoproblema resta disponibile anche se il tempo finisce dopo
+        if (context.incumbent.score != NO_SCORE) keepBetterResult(worker, &context.incumbent, taskIndex);
+        context.incumbent.score = NO_SCORE;
+    }
+
+    worker->nodes = context.nodes;
+    worker->timedOut = context.timedOut;
+    worker->stats = threadStats;
+    freeTranspositionTable(context.table);
+    freeMoveLists(&context);
+    endBoardPool();
+    return NULL;
+}
+
+/**
+ * Tiene una copia delle mosse di una partita se è migliore di quella del thread
+ * @param worker dati del thread
+ * @param moves mosse della partita trovata dal thread, dall'inizio della partita
+ * @param taskIndex indice del sottoproblema della partita
+ */
+void keepBetterResult(workerData *worker, moveList *moves, int taskIndex) {
+    if (worker->best.score == NO_SCORE || isBetterResult(moves->score, taskIndex, worker->best.score, worker->bestIndex)) {
+        copyMoveList(&worker->best, moves);
+        worker->bestIndex = taskIndex;
+    }
+}
+
+/**
+ * Confronta due risultati della ricerca parallela
+ * @param score punteggio del primo risultato
+ * @param index indice del sottoproblema del primo risultato
+ * @param otherScore punteggio del secondo risultato
+ * @param otherIndex indice del sottoproblema del secondo risultato
+ * @return se il primo risultato ha punteggio più alto, o uguale ma viene da un sottoproblema esplorato prima
+ */
+bool isBetterResult(int score, int index, int otherScore, int otherIndex) {
+    return score > otherScore || (score == otherScore && index < otherIndex);
+}
+
+/**
+ * Impacchetta punteggio e indice del sottoproblema in un valore che cresce con il punteggio e, a parità di
+ * punteggio, al diminuire dell'indice
+ * @param score punteggio (almeno NO_SCORE)
+ * @param index indice del sottoproblema
+ * @return valore impacchettato
+ */
+long long packBestScore(int score, int index) {
+    return ((long long) (score - NO_SCORE) << 32) | (long long) (0xFFFFFFFFu - (unsigned int) index);
+}
+
+/**
+ * Legge il punteggio che un sottoproblema deve superare per migliorare la migliore partita condivisa
+ * @param best migliore partita condivisa
+ * @param taskIndex indice del sottoproblema
+ * @return punteggio della migliore partita, diminuito di 1 se è stata trovata in un sottoproblema successivo
+ */
+int readSharedBestScore(sharedBestScore *best, int taskIndex) {
+    /** Valore impacchettato */
+    long long packed = __atomic_load_n(&best->packed, __ATOMIC_ACQUIRE);
+    /** Punteggio della migliore partita */
+    int score = (int) (packed >> 32) + NO_SCORE;
+    /** Indice del sottoproblema della migliore partita */
+    int index = (int) (0xFFFFFFFFu - (unsigned int) (packed & 0xFFFFFFFF));
+    return index > taskIndex ? score - 1 : score;
+}
+
+/**
+ * Aggiorna la migliore partita condivisa se quella data è migliore
+ * @param best migliore partita condivisa
+ * @param score punteggio della partita
+ * @param taskIndex indice del sottoproblema della partita
+ */
+void updateSharedBestScore(sharedBestScore *best, int score, int taskIndex) {
+    /** Valore impacchettato della partita */
+    long long packed = packBestScore(score, taskIndex);
+    /** Valore attuale */
+    long long current = __atomic_load_n(&best->packed, __ATOMIC_RELAXED);
+    while (packed > current
+           && !__atomic_compare_exchange_n(&best->packed, &current, packed, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
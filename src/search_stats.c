@@ -0,0 +1,86 @@
+/**
+ * @file search_stats.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente i contatori della ricerca AI: ogni thread incrementa i suoi (senza sincronizzazione,
+ * quindi restano sempre attivi), alla fine della ricerca vengono sommati e stampati con --stats.
+ * @date 17/10/2026
+ */
+
+#include "search_stats.h"
+
+/** Contatori del thread */
+THREAD_LOCAL searchStats threadStats;
+
+/**
+ * Azzera i contatori del thread
+ * @param timeSpecials se misurare anche il tempo speso a sistemare le tessere speciali
+ */
+void resetSearchStats(bool timeSpecials) {
+    searchStats empty = {.timeSpecials = timeSpecials};
+    threadStats = empty;
+}
+
+/**
+ * Somma i contatori di un thread a quelli totali
+ * @param total contatori totali
+ * @param part contatori da aggiungere
+ */
+void addSearchStats(searchStats *total, searchStats *part) {
+    for (int i = 0; i < MAX_STATS_DEPTH; ++i) total->nodesByTilesLeft[i] += part->nodesByTilesLeft[i];
+    total->copyGameCalls += part->copyGameCalls;
+    total->bytesCopied += part->bytesCopied;
+    total->validMoveCalls += part->validMoveCalls;
+    total->endGameScans += part->endGameScans;
+    total->tablebaseHits += part->tablebaseHits;
+    total->specialTileCalls += part->specialTileCalls;
+    total->specialTileNs += part->specialTileNs;
+}
+
+/**
+ * Conta una situazione di gioco esplorata
+ * @param tilesLeft tessere ancora in mano
+ */
+void countNode(int tilesLeft) {
+    threadStats.nodesByTilesLeft[tilesLeft < MAX_STATS_DEPTH ? tilesLeft : MAX_STATS_DEPTH - 1]++;
+}
+
+/**
+ * Stampa i contatori, le situazioni di gioco esplorate per profondità (numero di tessere messe)
+ * @param out file su cui stampare
+ * @param stats contatori da stampare
+ * @param numTiles tessere della mano
+ */
+void printSearchStats(FILE *out, searchStats *stats, int numTiles) {
+    fprintf(out, "Situazioni di gioco per profondita':");
+    for (int depth = 0; depth <= numTiles; ++depth) {
+        /** Tessere ancora in mano a questa profondità */
+        int tilesLeft = numTiles - depth;
+        if (tilesLeft < MAX_STATS_DEPTH && stats->nodesByTilesLeft[tilesLeft] > 0)
+            fprintf(out, " %d:%lld", depth, stats->nodesByTilesLeft[tilesLeft]);
+    }
+    fprintf(out, "\n");
+    fprintf(out, "Copie del campo: %lld (%lld byte)\n", stats->copyGameCalls, stats->bytesCopied);
+    fprintf(out, "Mosse controllate: %lld\n", stats->validMoveCalls);
+    fprintf(out, "Controlli di fine partita: %lld\n", stats->endGameScans);
+    fprintf(out, "Situazioni trovate nella tablebase: %lld\n", stats->tablebaseHits);
+    fprintf(out, "Tessere speciali sistemate: %lld (%.3f ms)\n", stats->specialTileCalls, stats->specialTileNs / 1e6);
+}
+
+/**
+ * Scrive i contatori come oggetto JSON (senza andare a capo) in un buffer di testo
+ * @param buffer buffer di testo
+ * @param stats contatori da scrivere
+ * @param numTiles tessere della mano
+ */
+void renderSearchStatsJSON(textBuffer *buffer, searchStats *stats, int numTiles) {
+    appendText(buffer, "{\"nodes_per_depth\":[");
+    for (int depth = 0; depth <= numTiles; ++depth) {
+        /** Tessere ancora in mano a questa profondità */
+        int tilesLeft = numTiles - depth;
+        appendFormat(buffer, depth == 0 ? "%lld" : ",%lld", tilesLeft < MAX_STATS_DEPTH ? stats->nodesByTilesLeft[tilesLeft] : 0);
+    }
+    appendFormat(buffer, "],\"copy_game_calls\":%lld,\"bytes_copied\":%lld,\"valid_move_calls\":%lld,\"end_game_scans\":%lld,"
+                         "\"tablebase_hits\":%lld,\"special_tile_calls\":%lld,\"special_tile_ms\":%.3f}",
+            stats->copyGameCalls, stats->bytesCopied, stats->validMoveCalls, stats->endGameScans,
+            stats->tablebaseHits, stats->specialTileCalls, stats->specialTileNs / 1e6);
+}
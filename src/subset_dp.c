@@ -0,0 +1,273 @@
+/**
+ * @file subset_dp.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente il risolutore esatto a programmazione dinamica per le mani giocate su una sola fila.
+ * Ogni cella viene contata con il valore che avrà a fine partita: le tessere speciali si possono sempre mettere,
+ * quindi tutte le [11|11] rimaste in mano verranno giocate e incrementeranno ogni cella già in gioco. Così il
+ * punteggio di una mossa dipende solo dalle tessere in mano e dalle estremità, non da tutto il campo.
+ * @date 17/10/2026
+ */
+
+#include "subset_dp.h"
+
+/**
+ * Stima la memoria necessaria alla programmazione dinamica per le tessere date, prima di allocarla
+ * @param tilesOnHand tessere in mano
+ * @param numTilesOnHand numero di tessere in mano
+ * @return byte della tabella, LLONG_MAX se sono troppi anche solo da contare
+ */
+long long estimateSubsetDPBytes(dominoTile *tilesOnHand, int numTilesOnHand) {
+    tileHand hand = createTileHand(tilesOnHand, numTilesOnHand);
+    /** Combinazioni delle tessere usate diverse dalle [12|21] */
+    long long restMasks = 1;
+    for (int type = 0; type < NUM_TILE_TYPES; ++type) {
+        if (type == MIRROR_TYPE) continue;
+        if (restMasks > LLONG_MAX / 256 / SUBSET_DP_FULL_ENDS / NUM_TILE_TYPES) return LLONG_MAX;
+        restMasks *= hand.counts[type] + 1;
+    }
+    /** Voci per ogni combinazione delle tessere diverse dalle [12|21] */
+    long long perMask = (long long) hand.counts[MIRROR_TYPE] * SUBSET_DP_FULL_ENDS + SUBSET_DP_OUTER_ENDS;
+    if (restMasks > LLONG_MAX / (long long) sizeof(unsigned short) / perMask) return LLONG_MAX;
+    return restMasks * perMask * (long long) sizeof(unsigned short);
+}
+
+/**
+ * Trova la migliore partita su una sola fila con la programmazione dinamica. Conviene controllare prima la memoria
+ * necessaria con estimateSubsetDPBytes.
+ * @param tilesOnHand tessere in mano (almeno una normale)
+ * @param numTilesOnHand numero di tessere in mano
+ * @param states se non è NULL viene aggiornato con il numero di voci calcolate
+ * @param moves lista di almeno numTilesOnHand mosse in cui salvare le mosse della partita
+ * @return partita con tutte le tessere in orizzontale nella prima riga, da liberare con freeGameSituation,
+ * NULL se non c'è memoria per la tabella
+ */
+gameSituation *getBestSubsetDPGame(dominoTile *tilesOnHand, int numTilesOnHand, long long *states, moveList *moves) {
+    /** Tessere in mano contate per tipo */
+    tileHand hand = createTileHand(tilesOnHand, numTilesOnHand);
+    subsetDP dp = createSubsetDP(&hand);
+    if (!dp.values) return NULL;
+
+    // La prima tessera deve essere normale, le altre si attaccano alle due estremità della fila
+    /** Tipo della migliore prima tessera */
+    int firstType = -1;
+    /** Miglior punteggio */
+    int best = -1;
+    for (int type = 0; type < NUM_NORMAL_TYPES; ++type) {
+        if (hand.counts[type] == 0) continue;
+        dominoTile tile = getTileOfType(type);
+        rowEnds ends = {tile.left, tile.right, tile.right, tile.left};
+        /** Incrementi che verranno fatti dopo la prima tessera */
+        int increments = hand.counts[INCREMENT_TYPE];
+        removeTileFromHand(&hand, type);
+        /** Punteggio della partita con questa prima tessera */
+        int score = rotateValue(tile.left, increments) + rotateValue(tile.right, increments)
+                    + solveSubsetDP(&dp, &hand, dp.strides[type], ends);
+        addTileToHand(&hand, type);
+        if (score > best) {
+            best = score;
+            firstType = type;
+        }
+    }
+
+    // Segue le mosse che raggiungono il miglior punteggio, tenendo le colonne del campo su cui verranno rifatte
+    dominoTile first = getTileOfType(firstType);
+    moves->moves[0].tile = first;
+    moves->moves[0].row = moves->moves[0].col = 0;
+    moves->moves[0].orientation = HORIZONTAL;
+    moves->moves[0].isLinkedTo = NOT_VALID_CHAR;
+    moves->numMoves = 1;
+    moves->score = best;
+    /** Colonne del campo */
+    int cols = 2;
+    removeTileFromHand(&hand, firstType);
+    /** Indice delle tessere usate */
+    long long restIndex = dp.strides[firstType];
+    /** Estremità della fila */
+    rowEnds ends = {first.left, first.right, first.right, first.left};
+    /** Se c'è ancora una mossa da fare */
+    bool moved = true;
+    while (moved) {
+        moved = false;
+        /** Miglior punteggio aggiuntivo della situazione attuale */
+        int target = solveSubsetDP(&dp, &hand, restIndex, ends);
+        for (int type = 0; type < NUM_TILE_TYPES && !moved; ++type) {
+            if (hand.counts[type] == 0) continue;
+            for (int side = 0; side < 2 && !moved; ++side) {
+                /** Da che parte attaccare la tessera, prima a sinistra come nella ricerca */
+                char isLinkedTo = side == 0 ? LEFT : RIGHT;
+                rowEnds next;
+                int gain;
+                if (!getSubsetDPMove(type, isLinkedTo, ends, hand.counts[INCREMENT_TYPE], &next, &gain)) continue;
+                removeTileFromHand(&hand, type);
+                if (gain + solveSubsetDP(&dp, &hand, restIndex + dp.strides[type], next) == target) {
+                    /** Mossa fatta */
+                    placedTile *move = &moves->moves[moves->numMoves++];
+                    move->tile = getTileOfType(type);
+                    /** Lato della tessera non girata che tocca l'estremità */
+                    int near = isLinkedTo == LEFT ? move->tile.right : move->tile.left;
+                    // Come in getSubsetDPMove una tessera normale viene girata solo se non è valida così com'è
+                    if (!isSpecialType(type) && near != (isLinkedTo == LEFT ? next.leftInner : next.rightInner))
+                        rotateDominoTile(&move->tile);
+                    move->row = 0;
+                    // La fila comincia sempre dalla prima colonna
+                    move->col = isLinkedTo == LEFT ? 0 : cols - 1;
+                    move->orientation = HORIZONTAL;
+                    move->isLinkedTo = isLinkedTo;
+                    cols += 2;
+                    restIndex += dp.strides[type];
+                    ends = next;
+                    moved = true;
+                } else {
+                    addTileToHand(&hand, type);
+                }
+            }
+        }
+    }
+
+    if (states) *states = dp.states;
+    free(dp.values);
+    return replayMoves(moves, numTilesOnHand);
+}
+
+/**
+ * Crea la tabella della programmazione dinamica per le tessere date, con tutte le voci da calcolare
+ * @param hand tessere in mano
+ * @return tabella, con values NULL se non c'è memoria (da liberare con free(values))
+ */
+subsetDP createSubsetDP(tileHand *hand) {
+    subsetDP dp = {.restMasks = 1, .mirrors = hand->counts[MIRROR_TYPE], .states = 0};
+    for (int type = 0; type < NUM_TILE_TYPES; ++type) {
+        dp.strides[type] = type == MIRROR_TYPE ? 0 : dp.restMasks;
+        if (type != MIRROR_TYPE) dp.restMasks *= hand->counts[type] + 1;
+    }
+    dp.numEntries = dp.restMasks * ((long long) dp.mirrors * SUBSET_DP_FULL_ENDS + SUBSET_DP_OUTER_ENDS);
+    dp.values = (unsigned short *) malloc(sizeof(unsigned short) * dp.numEntries);
+    if (dp.values) memset(dp.values, 0xFF, sizeof(unsigned short) * dp.numEntries);
+    return dp;
+}
+
+/**
+ * Calcola il miglior punteggio aggiuntivo di una situazione di gioco, contando ogni cella messa d'ora in poi con
+ * il valore che avrà a fine partita (insieme agli incrementi delle [11|11] su quelle già in gioco)
+ * @param dp tabella della programmazione dinamica
+ * @param hand tessere in mano, modificata durante il calcolo e ripristinata alla fine
+ * @param restIndex indice delle tessere usate diverse dalle [12|21]
+ * @param ends valori alle estremità della fila (quelli attuali, non quelli di fine partita)
+ * @return miglior punteggio aggiuntivo, 0 se la partita è finita
+ */
+int solveSubsetDP(subsetDP *dp, tileHand *hand, long long restIndex, rowEnds ends) {
+    /** Voce della tabella */
+    long long entry = getSubsetDPEntry(dp, hand, restIndex, ends);
+    if (dp->values[entry] != SUBSET_DP_UNKNOWN) return dp->values[entry];
+
+    /** Miglior punteggio aggiuntivo, resta 0 se non si può più mettere nessuna tessera */
+    int best = 0;
+    for (int type = 0; type < NUM_TILE_TYPES; ++type) {
+        if (hand->counts[type] == 0) continue;
+        for (int side = 0; side < 2; ++side) {
+            rowEnds next;
+            int gain;
+            if (!getSubsetDPMove(type, side == 0 ? LEFT : RIGHT, ends, hand->counts[INCREMENT_TYPE], &next, &gain))
+                continue;
+            removeTileFromHand(hand, type);
+            /** Punteggio aggiuntivo con questa mossa */
+            int score = gain + solveSubsetDP(dp, hand, restIndex + dp->strides[type], next);
+            addTileToHand(hand, type);
+            if (score > best) best = score;
+        }
+    }
+    dp->values[entry] = (unsigned short) best;
+    dp->states++;
+    return best;
+}
+
+/**
+ * Calcola la voce della tabella di una situazione di gioco. Finché c'è una [12|21] in mano le voci usano tutti e
+ * quattro i valori delle estremità, dopo solo i due esterni
+ * @param dp tabella della programmazione dinamica
+ * @param hand tessere in mano
+ * @param restIndex indice delle tessere usate diverse dalle [12|21]
+ * @param ends valori alle estremità della fila
+ * @return indice della voce in dp->values
+ */
+long long getSubsetDPEntry(subsetDP *dp, tileHand *hand, long long restIndex, rowEnds ends) {
+    /** [12|21] già usate */
+    long long mirrorsUsed = dp->mirrors - hand->counts[MIRROR_TYPE];
+    if (mirrorsUsed < dp->mirrors)
+        return (mirrorsUsed * dp->restMasks + restIndex) * SUBSET_DP_FULL_ENDS
+               + ((ends.left * 7 + ends.leftInner) * 7 + ends.right) * 7 + ends.rightInner;
+    return dp->mirrors * dp->restMasks * SUBSET_DP_FULL_ENDS + restIndex * SUBSET_DP_OUTER_ENDS
+           + ends.left * 7 + ends.right;
+}
+
+/**
+ * Calcola l'effetto di una tessera attaccata a un'estremità della fila con le stesse regole della partita: una
+ * tessera normale va girata solo se non è valida così com'è, accanto a uno 0 va bene qualsiasi tessera e le
+ * speciali assumono i valori di fixSpecialTiles
+ * @param type tipo della tessera
+ * @param isLinkedTo estremità a cui attaccarla, LEFT o RIGHT
+ * @param ends valori alle estremità della fila
+ * @param increments [11|11] in mano, compresa la tessera se è una [11|11]
+ * @param next dove salvare i valori alle estremità dopo la mossa
+ * @param gain dove salvare i punti della tessera a fine partita
+ * @return se la tessera si può attaccare
+ */
+bool getSubsetDPMove(int type, char isLinkedTo, rowEnds ends, int increments, rowEnds *next, int *gain) {
+    /** Valore e valore interno dell'estremità a cui si attacca la tessera */
+    int end = isLinkedTo == LEFT ? ends.left : ends.right;
+    int inner = isLinkedTo == LEFT ? ends.leftInner : ends.rightInner;
+    /** Lato esterno e lato interno della tessera messa */
+    int outer, touching;
+    *next = ends;
+    if (type == ZERO_TYPE) {
+        outer = touching = 0;
+        *gain = 0;
+    } else if (type == INCREMENT_TYPE) {
+        // Tutte le celle vengono incrementate, poi la tessera prende il valore di quella a cui si attacca
+        next->left = rotateValue(ends.left, 1);
+        next->leftInner = rotateValue(ends.leftInner, 1);
+        next->right = rotateValue(ends.right, 1);
+        next->rightInner = rotateValue(ends.rightInner, 1);
+        outer = touching = rotateValue(end, 1);
+        *gain = 2 * rotateValue(end, increments);
+    } else if (type == MIRROR_TYPE) {
+        // Copia girata della tessera a cui si attacca
+        outer = inner;
+        touching = end;
+        *gain = rotateValue(end, increments) + rotateValue(inner, increments);
+    } else {
+        dominoTile tile = getTileOfType(type);
+        /** Lato della tessera non girata che tocca l'estremità */
+        int near = isLinkedTo == LEFT ? tile.right : tile.left;
+        /** Altro lato della tessera non girata */
+        int far = isLinkedTo == LEFT ? tile.left : tile.right;
+        if (end == 0 || near == end) {
+            outer = far;
+            touching = near;
+        } else if (far == end) {
+            outer = near;
+            touching = far;
+        } else {
+            return false;
+        }
+        *gain = rotateValue(tile.left, increments) + rotateValue(tile.right, increments);
+    }
+    if (isLinkedTo == LEFT) {
+        next->left = outer;
+        next->leftInner = touching;
+    } else {
+        next->right = outer;
+        next->rightInner = touching;
+    }
+    return true;
+}
+
+/**
+ * Incrementa un valore come la [11|11]: dopo il 6 torna a 1, lo 0 resta 0
+ * @param value valore da 0 a 6
+ * @param times numero di incrementi
+ * @return valore incrementato
+ */
+int rotateValue(int value, int times) {
+    return value == 0 ? 0 : (value - 1 + times) % 6 + 1;
+}
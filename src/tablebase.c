@@ -0,0 +1,250 @@
+/**
+ * @file tablebase.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la tablebase dei finali: per ogni mano di poche tessere normali e ogni coppia di valori
+ * alle estremità della fila, il miglior punteggio aggiuntivo giocando su una sola fila. Viene calcolata una volta
+ * da tools/gen_tablebase.c, salvata in un file binario e letta con mmap (le pagine vengono caricate solo quando servono).
+ * @date 17/10/2026
+ */
+
+// mmap, open, fstat
+#define _POSIX_C_SOURCE 200112L
+
+#include "tablebase.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Mappa in memoria il file della tablebase. Il file non viene letto: il sistema carica le pagine alla prima
+ * ricerca che le usa, quindi aprire la tablebase costa sempre poco.
+ * @param path file generato da writeTablebase
+ * @return tablebase da chiudere con closeTablebase, NULL se il file non esiste o non è valido
+ */
+endgameTablebase *openTablebase(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Impossibile aprire la tablebase %s\n", path);
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(tablebaseHeader)) {
+        fprintf(stderr, "Tablebase %s non valida\n", path);
+        close(fd);
+        return NULL;
+    }
+    /** Memoria mappata del file */
+    void *mapping = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // La mappatura resta valida anche dopo aver chiuso il file
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Impossibile mappare la tablebase %s\n", path);
+        return NULL;
+    }
+
+    /** Intestazione del file */
+    const tablebaseHeader *header = (const tablebaseHeader *) mapping;
+    /** Numero di voci attese con le tessere dell'intestazione */
+    long long expected = 0;
+    if (header->maxTiles <= MAX_TABLEBASE_TILES) {
+        for (int numTiles = 0; numTiles <= (int) header->maxTiles; ++numTiles)
+            expected += countMultisets(numTiles) * TABLEBASE_END_VALUES * TABLEBASE_END_VALUES;
+    }
+    if (strncmp(header->magic, TABLEBASE_MAGIC, sizeof(header->magic)) != 0 || header->endValues != TABLEBASE_END_VALUES
+        || header->numEntries != (unsigned long long) expected
+        || (size_t) info.st_size != sizeof(tablebaseHeader) + header->numEntries) {
+        fprintf(stderr, "Tablebase %s non valida\n", path);
+        munmap(mapping, (size_t) info.st_size);
+        return NULL;
+    }
+
+    endgameTablebase *tablebase = (endgameTablebase *) malloc(sizeof(endgameTablebase));
+    if (!tablebase) {
+        munmap(mapping, (size_t) info.st_size);
+        return NULL;
+    }
+    tablebase->mapping = mapping;
+    tablebase->size = (size_t) info.st_size;
+    tablebase->entries = (const unsigned char *) mapping + sizeof(tablebaseHeader);
+    tablebase->maxTiles = (int) header->maxTiles;
+    return tablebase;
+}
+
+/**
+ * Chiude la tablebase
+ * @param tablebase tablebase da chiudere (può essere NULL)
+ */
+void closeTablebase(endgameTablebase *tablebase) {
+    if (tablebase) {
+        munmap(tablebase->mapping, tablebase->size);
+        free(tablebase);
+    }
+}
+
+/**
+ * Cerca nella tablebase il miglior punteggio aggiuntivo di una situazione di gioco su una sola fila
+ * @param tablebase tablebase in cui cercare
+ * @param hand tessere in mano, solo normali e non più di tablebase->maxTiles
+ * @param leftValue valore dell'estremità sinistra della fila
+ * @param rightValue valore dell'estremità destra della fila
+ * @param value puntatore in cui salvare il miglior punteggio aggiuntivo
+ * @return se la situazione di gioco è nella tablebase
+ */
+bool probeTablebase(const endgameTablebase *tablebase, tileHand *hand, int leftValue, int rightValue, int *value) {
+    if (hand->numTiles > tablebase->maxTiles) return false;
+    if (hand->counts[ZERO_TYPE] || hand->counts[INCREMENT_TYPE] || hand->counts[MIRROR_TYPE]) return false;
+    /** Tipi delle tessere in mano in ordine crescente */
+    int types[MAX_TABLEBASE_TILES];
+    /** Tessere messe in types */
+    int numTiles = 0;
+    for (int type = 0; type < NUM_NORMAL_TYPES; ++type) {
+        for (int i = 0; i < hand->counts[type]; ++i) types[numTiles++] = type;
+    }
+    *value = tablebase->entries[tablebaseIndex(types, numTiles, leftValue, rightValue)];
+    return true;
+}
+
+/**
+ * Calcola la posizione di una voce della tablebase: le voci sono ordinate per numero di tessere in mano,
+ * poi per mano (numerata con il sistema combinatorio delle combinazioni con ripetizione), poi per estremità.
+ * @param types tipi delle tessere in mano in ordine crescente
+ * @param numTiles numero di tessere in mano
+ * @param leftValue valore dell'estremità sinistra della fila
+ * @param rightValue valore dell'estremità destra della fila
+ * @return indice della voce
+ */
+long long tablebaseIndex(const int *types, int numTiles, int leftValue, int rightValue) {
+    /** Mani con meno tessere, che vengono prima */
+    long long index = 0;
+    for (int smaller = 0; smaller < numTiles; ++smaller) index += countMultisets(smaller);
+    // Aggiungendo la posizione a ogni tipo la mano diventa una combinazione senza ripetizione
+    for (int i = 0; i < numTiles; ++i) index += binomial(types[i] + i, i + 1);
+    return (index * TABLEBASE_END_VALUES + leftValue) * TABLEBASE_END_VALUES + rightValue;
+}
+
+/**
+ * Conta le mani diverse di tessere normali con un certo numero di tessere (combinazioni con ripetizione)
+ * @param numTiles numero di tessere in mano
+ * @return numero di mani
+ */
+long long countMultisets(int numTiles) {
+    return binomial(NUM_NORMAL_TYPES + numTiles - 1, numTiles);
+}
+
+/**
+ * Calcola il coefficiente binomiale
+ * @param n numero di elementi
+ * @param k elementi scelti
+ * @return n su k, 0 se k > n
+ */
+long long binomial(int n, int k) {
+    if (k < 0 || k > n) return 0;
+    long long result = 1;
+    for (int i = 1; i <= k; ++i) result = result * (n - k + i) / i;
+    return result;
+}
+
+/**
+ * Passa alla mano successiva con lo stesso numero di tessere (tipi in ordine crescente)
+ * @param types tipi delle tessere in mano, aggiornati
+ * @param numTiles numero di tessere in mano
+ * @return false se era l'ultima mano
+ */
+bool nextMultiset(int *types, int numTiles) {
+    for (int i = numTiles - 1; i >= 0; --i) {
+        if (types[i] < NUM_NORMAL_TYPES - 1) {
+            types[i]++;
+            for (int j = i + 1; j < numTiles; ++j) types[j] = types[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Calcola il miglior punteggio aggiuntivo di una voce dalle voci con una tessera in meno, provando ogni tessera
+ * a ogni estremità come la ricerca AI: accanto ad uno 0 la tessera va bene non girata, altrimenti deve combaciare
+ * non girata oppure girata.
+ * @param entries voci già calcolate per le mani con meno tessere
+ * @param types tipi delle tessere in mano in ordine crescente
+ * @param numTiles numero di tessere in mano
+ * @param leftValue valore dell'estremità sinistra della fila
+ * @param rightValue valore dell'estremità destra della fila
+ * @return miglior punteggio aggiuntivo
+ */
+int solveTablebaseEntry(const unsigned char *entries, const int *types, int numTiles, int leftValue, int rightValue) {
+    /** Miglior punteggio aggiuntivo, 0 se nessuna tessera può essere attaccata */
+    int best = 0;
+    /** Tessere rimaste dopo aver messo quella provata */
+    int rest[MAX_TABLEBASE_TILES];
+    for (int i = 0; i < numTiles; ++i) {
+        // Le tessere uguali vengono provate una volta sola
+        if (i > 0 && types[i] == types[i - 1]) continue;
+        for (int j = 0, k = 0; j < numTiles; ++j) {
+            if (j != i) rest[k++] = types[j];
+        }
+        /** Tessera provata, con il numero più piccolo a sinistra */
+        dominoTile tile = getTileOfType(types[i]);
+        /** Nuovo valore dell'estremità, NOT_VALID_INT se la tessera non può essere attaccata */
+        int newEnd;
+
+        // A sinistra: la tessera non girata mette a sinistra il suo lato sinistro
+        if (leftValue == 0 || tile.right == leftValue) newEnd = tile.left;
+        else if (tile.left == leftValue) newEnd = tile.right;
+        else newEnd = NOT_VALID_INT;
+        if (newEnd != NOT_VALID_INT) {
+            int score = tile.left + tile.right + entries[tablebaseIndex(rest, numTiles - 1, newEnd, rightValue)];
+            if (score > best) best = score;
+        }
+
+        // A destra: la tessera non girata mette a destra il suo lato destro
+        if (rightValue == 0 || tile.left == rightValue) newEnd = tile.right;
+        else if (tile.right == rightValue) newEnd = tile.left;
+        else newEnd = NOT_VALID_INT;
+        if (newEnd != NOT_VALID_INT) {
+            int score = tile.left + tile.right + entries[tablebaseIndex(rest, numTiles - 1, leftValue, newEnd)];
+            if (score > best) best = score;
+        }
+    }
+    return best;
+}
+
+/**
+ * Calcola la tablebase e la salva su file
+ * @param path file da scrivere
+ * @param maxTiles numero massimo di tessere in mano
+ * @return se il file è stato scritto
+ */
+bool writeTablebase(const char *path, int maxTiles) {
+    /** Intestazione del file */
+    tablebaseHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC));
+    header.maxTiles = (unsigned int) maxTiles;
+    header.endValues = TABLEBASE_END_VALUES;
+    for (int numTiles = 0; numTiles <= maxTiles; ++numTiles)
+        header.numEntries += (unsigned long long) (countMultisets(numTiles) * TABLEBASE_END_VALUES * TABLEBASE_END_VALUES);
+
+    /** Voci della tablebase */
+    unsigned char *entries = (unsigned char *) calloc(header.numEntries, 1);
+    if (!entries) return false;
+    // Le mani vengono risolte per numero di tessere crescente: ogni voce usa solo quelle con una tessera in meno
+    for (int numTiles = 1; numTiles <= maxTiles; ++numTiles) {
+        /** Tipi delle tessere della mano, dalla prima mano [1|1][1|1]... */
+        int types[MAX_TABLEBASE_TILES] = {0};
+        do {
+            for (int left = 0; left < TABLEBASE_END_VALUES; ++left) {
+                for (int right = 0; right < TABLEBASE_END_VALUES; ++right)
+                    entries[tablebaseIndex(types, numTiles, left, right)] = (unsigned char) solveTablebaseEntry(entries, types, numTiles, left, right);
+            }
+        } while (nextMultiset(types, numTiles));
+    }
+
+    FILE *file = fopen(path, "wb");
+    bool written = file && fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(entries, 1, header.numEntries, file) == header.numEntries;
+    if (file && fclose(file) != 0) written = false;
+    free(entries);
+    return written;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file tile_hand.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la mano di tessere usata dalla modalità AI: per ogni tipo di tessera
+ * viene tenuto solo quante ce ne sono, così le tessere uguali vengono provate una volta sola.
+ * @date 17/10/2026
+ */
+
+#include "tile_hand.h"
+
+/**
+ * Crea la mano a partire da un array di tessere
+ * @param tilesOnHand tessere in mano
+ * @param numTilesOnHand numero di tessere in mano
+ * @return mano con il numero di tessere per ogni tipo
+ */
+tileHand createTileHand(dominoTile *tilesOnHand, int numTilesOnHand) {
+    tileHand hand = {.counts = {0}, .numTiles = 0, .pipCounts = {0}};
+    for (int i = 0; i < numTilesOnHand; ++i) {
+        addTileToHand(&hand, getTileType(tilesOnHand[i]));
+    }
+    return hand;
+}
+
+/**
+ * Restituisce il tipo di una tessera: le 21 tessere normali hanno indice da 0 a 20 (a prescindere dal verso),
+ * le speciali [0|0], [11|11] e [12|21] hanno rispettivamente indice 21, 22 e 23.
+ * @param tile tessera
+ * @return tipo della tessera
+ */
+int getTileType(dominoTile tile) {
+    switch (tile.left) {
+        case 0: return ZERO_TYPE;
+        case 11: return INCREMENT_TYPE;
+        case 12: return MIRROR_TYPE;
+    }
+    /** Numero più piccolo della tessera */
+    int low = tile.left < tile.right ? tile.left : tile.right;
+    /** Numero più grande della tessera */
+    int high = tile.left < tile.right ? tile.right : tile.left;
+    // Prima di [low|low] ci sono 6 + 5 + ... tessere, una per ogni numero più piccolo di low
+    return 6 * (low - 1) - (low - 1) * (low - 2) / 2 + (high - low);
+}
+
+/** Tipi di tessera dal più promettente: le normali dai punti più alti (a parità prima le doppie), poi le speciali */
+static const int typeOrder[NUM_TILE_TYPES] = {20, 19, 18, 17, 16, 14, 15, 13, 10, 12, 9, 5, 11, 8, 4, 7, 3, 6, 2, 1, 0,
+                                              INCREMENT_TYPE, MIRROR_TYPE, ZERO_TYPE};
+
+/**
+ * Restituisce i tipi di tessera nell'ordine in cui conviene provarli: prima le tessere che danno più punti,
+ * così la ricerca trova presto una partita con un punteggio alto e il pruning scarta di più
+ * @param index posizione nell'ordine, da 0 a NUM_TILE_TYPES - 1
+ * @return tipo della tessera
+ */
+int getOrderedType(int index) {
+    return typeOrder[index];
+}
+
+/**
+ * Restituisce la tessera di un tipo, con il numero più piccolo a sinistra come le genera generateTiles
+ * @param type tipo della tessera
+ * @return tessera
+ */
+dominoTile getTileOfType(int type) {
+    dominoTile tile;
+    switch (type) {
+        case ZERO_TYPE:
+            tile.left = tile.right = 0;
+            return tile;
+        case INCREMENT_TYPE:
+            tile.left = tile.right = 11;
+            return tile;
+        case MIRROR_TYPE:
+            tile.left = 12;
+            tile.right = 21;
+            return tile;
+    }
+    // I tipi con il numero più piccolo uguale a low sono 7 - low
+    tile.left = 1;
+    while (type >= 7 - tile.left) {
+        type -= 7 - tile.left;
+        tile.left++;
+    }
+    tile.right = tile.left + type;
+    return tile;
+}
+
+/**
+ * Controlla se un tipo di tessera è speciale
+ * @param type tipo della tessera
+ * @return se il tipo è [0|0], [11|11] o [12|21]
+ */
+bool isSpecialType(int type) {
+    return type >= NUM_NORMAL_TYPES;
+}
+
+/**
+ * Toglie una tessera dalla mano
+ * @param hand mano
+ * @param type tipo della tessera (deve essercene almeno una)
+ */
+void removeTileFromHand(tileHand *hand, int type) {
+    hand->counts[type]--;
+    hand->numTiles--;
+    if (!isSpecialType(type)) {
+        dominoTile tile = getTileOfType(type);
+        hand->pipCounts[tile.left]--;
+        if (tile.right != tile.left) hand->pipCounts[tile.right]--;
+    }
+}
+
+/**
+ * Rimette una tessera nella mano
+ * @param hand mano
+ * @param type tipo della tessera
+ */
+void addTileToHand(tileHand *hand, int type) {
+    hand->counts[type]++;
+    hand->numTiles++;
+    if (!isSpecialType(type)) {
+        dominoTile tile = getTileOfType(type);
+        hand->pipCounts[tile.left]++;
+        if (tile.right != tile.left) hand->pipCounts[tile.right]++;
+    }
+}
+
+/**
+ * Restituisce i valori presenti sulle tessere normali in mano
+ * @param hand mano
+ * @return maschera con il bit v acceso se almeno una tessera normale ha il valore v
+ */
+int getHandPipMask(tileHand *hand) {
+    int mask = 0;
+    for (int value = 1; value <= 6; ++value) {
+        if (hand->pipCounts[value] > 0) mask |= 1 << value;
+    }
+    return mask;
+}
@@ -0,0 +1,237 @@
+/**
+ * @file trail_solver.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente il risolutore esatto delle mani senza tessere speciali giocate su una sola fila.
+ * In un cammino ogni valore compare un numero pari di volte, tranne al più i due valori alle estremità: tra le
+ * tessere con gli stessi due valori conviene usarle tutte o tutte tranne una (per sistemare i valori dispari),
+ * le doppie vanno sempre usate tutte. Le scelte sono al massimo 2^15 per ognuno dei 63 insiemi di valori usati,
+ * quindi il tempo non dipende dal numero di tessere in mano.
+ * @date 17/10/2026
+ */
+
+#include "trail_solver.h"
+
+/**
+ * Controlla se la migliore partita delle tessere date si può trovare con getBestTrailGame
+ * @param tilesOnHand tessere in mano
+ * @param numTilesOnHand numero di tessere in mano
+ * @param vertical se le tessere possono essere messe in verticale
+ * @return se si gioca su una sola fila e non ci sono tessere speciali
+ */
+bool canSolveAsTrail(dominoTile *tilesOnHand, int numTilesOnHand, bool vertical) {
+    if (vertical || numTilesOnHand == 0) return false;
+    for (int i = 0; i < numTilesOnHand; ++i) {
+        if (tilesOnHand[i].left == 0 || tilesOnHand[i].left == 11 || tilesOnHand[i].left == 12) return false;
+    }
+    return true;
+}
+
+/**
+ * Trova la migliore partita su una sola fila di una mano senza tessere speciali
+ * @param tilesOnHand tessere in mano (solo normali)
+ * @param numTilesOnHand numero di tessere in mano
+ * @param moves lista di almeno numTilesOnHand mosse in cui salvare le mosse della partita
+ * @return partita con tutte le tessere in orizzontale nella prima riga, da liberare con freeGameSituation
+ */
+gameSituation *getBestTrailGame(dominoTile *tilesOnHand, int numTilesOnHand, moveList *moves) {
+    /** Tessere in mano per coppia di valori (con il valore più piccolo come primo indice) */
+    int counts[TRAIL_VALUES][TRAIL_VALUES] = {{0}};
+    for (int i = 0; i < numTilesOnHand; ++i) {
+        int low = tilesOnHand[i].left < tilesOnHand[i].right ? tilesOnHand[i].left : tilesOnHand[i].right;
+        int high = tilesOnHand[i].left < tilesOnHand[i].right ? tilesOnHand[i].right : tilesOnHand[i].left;
+        counts[low][high]++;
+    }
+    /** Tessere del cammino per coppia di valori */
+    int chosen[TRAIL_VALUES][TRAIL_VALUES];
+    /** Punteggio della partita */
+    int score = chooseTrailTiles(counts, chosen);
+    /** Numero di tessere del cammino */
+    int numTiles = 0;
+    for (int low = 1; low < TRAIL_VALUES; ++low) {
+        for (int high = low; high < TRAIL_VALUES; ++high) numTiles += chosen[low][high];
+    }
+    /** Valori del cammino, uno in più delle tessere */
+    int *trail = (int *) malloc(sizeof(int) * (numTiles + 1));
+    if (!trail) return NULL;
+    buildTrail(chosen, numTiles, trail);
+
+    gameSituation *game = (gameSituation *) allocBoardMemory(sizeof(gameSituation));
+    gameSituation empty = {
+            .inGameDominoTiles = createInGameDominoTiles(1, 2 * numTiles, 0),
+            .rows = 1,
+            .cols = 2 * numTiles,
+            .score = score
+    };
+    *game = empty;
+    for (int i = 0; i < numTiles; ++i) {
+        game->inGameDominoTiles[0][2 * i] = packCell(trail[i], LEFT);
+        game->inGameDominoTiles[0][2 * i + 1] = packCell(trail[i + 1], RIGHT);
+        // Dopo la prima, ogni tessera viene attaccata a destra della precedente
+        moves->moves[i].tile.left = trail[i];
+        moves->moves[i].tile.right = trail[i + 1];
+        moves->moves[i].row = 0;
+        moves->moves[i].col = 2 * i - 1;
+        moves->moves[i].orientation = HORIZONTAL;
+        moves->moves[i].isLinkedTo = i == 0 ? NOT_VALID_CHAR : RIGHT;
+    }
+    moves->numMoves = numTiles;
+    moves->score = score;
+    free(trail);
+    return game;
+}
+
+/**
+ * Sceglie le tessere del cammino di peso massimo: per ogni insieme di valori prova a togliere o no una tessera
+ * per ogni coppia di valori diversi e tiene la scelta con più punti che forma un cammino
+ * @param counts tessere in mano per coppia di valori (primo indice non più grande del secondo)
+ * @param chosen matrice in cui salvare le tessere del cammino per coppia di valori
+ * @return punteggio del cammino (somma dei valori delle tessere scelte)
+ */
+int chooseTrailTiles(int counts[TRAIL_VALUES][TRAIL_VALUES], int chosen[TRAIL_VALUES][TRAIL_VALUES]) {
+    /** Punteggio del miglior cammino trovato */
+    int best = 0;
+    memset(chosen, 0, sizeof(int) * TRAIL_VALUES * TRAIL_VALUES);
+    /** Tessere della scelta provata */
+    int tried[TRAIL_VALUES][TRAIL_VALUES];
+    // Bit v - 1 acceso se il valore v fa parte del cammino
+    for (int values = 1; values < 1 << (TRAIL_VALUES - 1); ++values) {
+        /** Coppie di valori diversi del cammino con almeno una tessera in mano */
+        int pairLow[15], pairHigh[15];
+        /** Numero di coppie */
+        int numPairs = 0;
+        /** Punteggio usando tutte le tessere con entrambi i valori nell'insieme */
+        int allScore = 0;
+        memset(tried, 0, sizeof(tried));
+        for (int low = 1; low < TRAIL_VALUES; ++low) {
+            if (!(values & 1 << (low - 1))) continue;
+            for (int high = low; high < TRAIL_VALUES; ++high) {
+                if (!(values & 1 << (high - 1)) || counts[low][high] == 0) continue;
+                tried[low][high] = counts[low][high];
+                allScore += counts[low][high] * (low + high);
+                if (high != low) {
+                    pairLow[numPairs] = low;
+                    pairHigh[numPairs] = high;
+                    numPairs++;
+                }
+            }
+        }
+        if (allScore <= best) continue;
+
+        // Bit i acceso se della coppia i viene lasciata in mano una tessera
+        for (int removed = 0; removed < 1 << numPairs; ++removed) {
+            /** Punteggio della scelta */
+            int score = allScore;
+            for (int i = 0; i < numPairs; ++i) {
+                if (removed & 1 << i) score -= pairLow[i] + pairHigh[i];
+            }
+            if (score <= best) continue;
+            for (int i = 0; i < numPairs; ++i)
+                tried[pairLow[i]][pairHigh[i]] = counts[pairLow[i]][pairHigh[i]] - ((removed >> i) & 1);
+            if (isTrail(tried, values)) {
+                best = score;
+                memcpy(chosen, tried, sizeof(tried));
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * Controlla se delle tessere si possono mettere tutte in una sola fila: ogni valore dell'insieme deve essere su
+ * almeno una tessera, i valori devono essere collegati dalle tessere e al più due valori possono comparire
+ * un numero dispari di volte
+ * @param chosen tessere per coppia di valori (primo indice non più grande del secondo)
+ * @param values insieme dei valori, bit v - 1 acceso per il valore v
+ * @return se le tessere formano un cammino
+ */
+bool isTrail(int chosen[TRAIL_VALUES][TRAIL_VALUES], int values) {
+    /** Valori raggiunti dal primo valore dell'insieme */
+    int reached = values & -values;
+    /** Valori da cui continuare la visita */
+    int toVisit = reached;
+    while (toVisit) {
+        /** Valore visitato */
+        int value = 1;
+        while (!(toVisit & 1 << (value - 1))) value++;
+        toVisit &= ~(1 << (value - 1));
+        for (int other = 1; other < TRAIL_VALUES; ++other) {
+            int tiles = value < other ? chosen[value][other] : chosen[other][value];
+            if (other != value && tiles > 0 && !(reached & 1 << (other - 1))) {
+                reached |= 1 << (other - 1);
+                toVisit |= 1 << (other - 1);
+            }
+        }
+    }
+    if (reached != values) return false;
+
+    /** Valori che compaiono un numero dispari di volte */
+    int odd = 0;
+    /** Se c'è almeno una tessera */
+    bool any = false;
+    for (int value = 1; value < TRAIL_VALUES; ++value) {
+        /** Lati delle tessere scelte con questo valore, le doppie contano due volte */
+        int degree = 0;
+        for (int other = 1; other < TRAIL_VALUES; ++other) {
+            int tiles = value < other ? chosen[value][other] : chosen[other][value];
+            degree += other == value ? 2 * tiles : tiles;
+        }
+        if (degree % 2 == 1) odd++;
+        if (degree > 0) any = true;
+    }
+    return any && odd <= 2;
+}
+
+/**
+ * Mette in fila le tessere scelte con l'algoritmo di Hierholzer: parte da un valore dispari (se c'è) e prende
+ * sempre la tessera con l'altro valore più piccolo, tornando indietro quando un valore non ha più tessere
+ * @param chosen tessere per coppia di valori che formano un cammino (isTrail), non viene modificata
+ * @param numTiles numero di tessere
+ * @param trail array di numTiles + 1 valori in cui salvare il cammino: la tessera i è [trail[i]|trail[i + 1]]
+ * @return numero di valori salvati
+ */
+int buildTrail(int chosen[TRAIL_VALUES][TRAIL_VALUES], int numTiles, int *trail) {
+    /** Tessere non ancora messe, per entrambi gli ordini dei valori */
+    int left[TRAIL_VALUES][TRAIL_VALUES];
+    /** Primo valore con almeno una tessera */
+    int start = 0;
+    /** Primo valore che compare un numero dispari di volte, il cammino deve partire da lì */
+    int oddStart = 0;
+    for (int value = 1; value < TRAIL_VALUES; ++value) {
+        /** Lati delle tessere con questo valore, le doppie contano due volte */
+        int degree = 0;
+        for (int other = 1; other < TRAIL_VALUES; ++other) {
+            left[value][other] = value < other ? chosen[value][other] : chosen[other][value];
+            degree += other == value ? 2 * left[value][other] : left[value][other];
+        }
+        if (degree > 0 && start == 0) start = value;
+        if (degree % 2 == 1 && oddStart == 0) oddStart = value;
+    }
+    if (oddStart != 0) start = oddStart;
+
+    /** Valori del cammino in costruzione */
+    int *stack = (int *) malloc(sizeof(int) * (numTiles + 1));
+    if (!stack) return 0;
+    /** Valori nella pila */
+    int top = 0;
+    /** Valori salvati in trail, in ordine inverso */
+    int length = 0;
+    stack[top++] = start;
+    while (top > 0) {
+        /** Valore in cima alla pila */
+        int value = stack[top - 1];
+        /** Altro valore della prima tessera non ancora messa */
+        int next = 1;
+        while (next < TRAIL_VALUES && left[value][next] == 0) next++;
+        if (next < TRAIL_VALUES) {
+            left[value][next]--;
+            if (next != value) left[next][value]--;
+            stack[top++] = next;
+        } else {
+            trail[numTiles - length] = value;
+            length++;
+            top--;
+        }
+    }
+    free(stack);
+    return length;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file transposition_table.c
+ * @author Nicolae Boldisor
+ * @brief Libreria contenente la tabella delle trasposizioni usata dalla modalità AI per non
+ * risolvere più volte la stessa situazione di gioco.
+ * @date 17/10/2026
+ */
+
+#include "transposition_table.h"
+
+/**
+ * Crea una tabella delle trasposizioni vuota.
+ * @param sizeLog2 logaritmo in base 2 del numero di voci della tabella
+ * @return tabella creata oppure NULL se non c'è memoria sufficiente (l'AI funziona comunque senza)
+ */
+transpositionTable *createTranspositionTable(int sizeLog2) {
+    transpositionTable *table = (transpositionTable *) malloc(sizeof(transpositionTable));
+    if (!table) return NULL;
+    /** Numero di voci della tabella, almeno un bucket da 2 voci */
+    unsigned long long numEntries = 1ULL << (sizeLog2 < 1 ? 1 : sizeLog2);
+    table->entries = (transpositionEntry *) calloc(numEntries, sizeof(transpositionEntry));
+    if (!table->entries) {
+        free(table);
+        return NULL;
+    }
+    table->mask = numEntries / 2 - 1;
+    return table;
+}
+
+/**
+ * Libera la memoria della tabella delle trasposizioni
+ * @param table tabella da liberare
+ */
+void freeTranspositionTable(transpositionTable *table) {
+    if (table) {
+        free(table->entries);
+        free(table);
+    }
+}
+
+/**
+ * Cerca nella tabella una situazione di gioco.
+ * @param table tabella in cui cercare
+ * @param key hash della situazione di gioco
+ * @param value puntatore in cui salvare il miglior punteggio aggiuntivo salvato
+ * @param bound puntatore in cui salvare il tipo di valore salvato (EXACT_SCORE o UPPER_SCORE)
+ * @return se la situazione di gioco è presente nella tabella
+ */
+bool probeTranspositionTable(transpositionTable *table, unsigned long long key, int *value, char *bound) {
+    /** Prima voce del bucket in cui si trova la situazione di gioco */
+    transpositionEntry *bucket = table->entries + 2 * (key & table->mask);
+    for (int i = 0; i < 2; ++i) {
+        // Le voci con bound a 0 sono vuote
+        if (bucket[i].key == key && bucket[i].bound != 0) {
+            *value = bucket[i].value;
+            *bound = bucket[i].bound;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Salva nella tabella il miglior punteggio aggiuntivo di una situazione di gioco.
+ * @param table tabella in cui salvare
+ * @param key hash della situazione di gioco
+ * @param value miglior punteggio aggiuntivo (oppure suo limite superiore)
+ * @param bound EXACT_SCORE se value è esatto, UPPER_SCORE se è un limite superiore
+ * @param depth numero di tessere in mano nella situazione di gioco
+ */
+void storeTranspositionTable(transpositionTable *table, unsigned long long key, int value, char bound, int depth) {
+    /** Prima voce del bucket in cui salvare la situazione di gioco */
+    transpositionEntry *bucket = table->entries + 2 * (key & table->mask);
+    /** Voce da sovrascrivere */
+    transpositionEntry *entry;
+    if (depth > 127) depth = 127;
+    // La prima voce tiene le situazioni con più tessere in mano (sottoalberi più costosi da ricalcolare),
+    // la seconda viene sempre sovrascritta
+    if (bucket[0].key == key || bucket[0].bound == 0 || depth >= bucket[0].depth)
+        entry = bucket;
+    else
+        entry = bucket + 1;
+    entry->key = key;
+    entry->value = value;
+    entry->bound = bound;
+    entry->depth = (char) depth;
+}
+
+/**
+ * Restituisce la chiave pseudo-casuale (stile Zobrist) associata ad un indice, calcolata
+ * con il mix di splitmix64 così da non dover dimensionare una tabella di chiavi sulla grandezza del campo.
+ * @param index indice della componente della situazione di gioco (cella o tessera)
+ * @return chiave a 64 bit
+ */
+unsigned long long zobristKey(unsigned long long index) {
+    unsigned long long z = index + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Calcola l'hash delle tessere in mano: combina le chiavi dei tipi di tessere con la loro molteplicità,
+ * quindi l'ordine delle tessere non conta.
+ * @param hand tessere in mano
+ * @return hash delle tessere in mano
+ */
+unsigned long long hashTileHand(tileHand *hand) {
+    /** Hash calcolato */
+    unsigned long long hash = 0;
+    for (int type = 0; type < NUM_TILE_TYPES; ++type) {
+        if (hand->counts[type] > 0)
+            hash ^= zobristKey((1ULL << 61) | ((unsigned long long) type << 32) | (unsigned long long) hand->counts[type]);
+    }
+    return hash;
+}
+
+/**
+ * Calcola l'hash di una situazione di gioco: combina le chiavi delle tessere in mano, delle celle occupate del campo
+ * e delle dimensioni del campo.
+ * @param hand tessere in mano
+ * @param game situazione di gioco
+ * @return hash della situazione di gioco
+ */
+unsigned long long hashGameState(tileHand *hand, gameSituation game) {
+    /** Hash calcolato */
+    unsigned long long hash = zobristKey((1ULL << 62) | ((unsigned long long) game.rows << 24) | (unsigned long long) game.cols)
+                              ^ hashTileHand(hand);
+    for (int row = 0; row < game.rows; ++row) {
+        for (int cell = 0; cell < game.cols; ++cell) {
+            /** Lato della tessera nella cella */
+            dominoTileSide side = game.inGameDominoTiles[row][cell];
+            if (side != EMPTY_CELL) {
+                hash ^= zobristKey(((unsigned long long) row << 40) | ((unsigned long long) cell << 16)
+                                   | ((unsigned long long) getSideValue(&game, row, cell) << 8) | (unsigned long long) getCellSide(side));
+            }
+        }
+    }
+    return hash;
+}
+
+/**
+ * Calcola l'hash di una situazione di gioco su una sola fila, uguale per la fila e per la sua immagine speculare:
+ * conta solo la sequenza dei valori (non la colonna in cui inizia), letta nel verso che dà l'hash più piccolo.
+ * Da usare solo quando la situazione di gioco e la sua immagine speculare hanno lo stesso miglior punteggio aggiuntivo.
+ * @param hand tessere in mano
+ * @param game situazione di gioco con tutte le tessere in orizzontale nella prima riga
+ * @return hash della situazione di gioco
+ */
+unsigned long long hashLinearGameState(tileHand *hand, gameSituation game) {
+    /** Riga del campo */
+    dominoTileSide *cells = game.inGameDominoTiles[0];
+    /** Prima colonna occupata */
+    int first = 0;
+    /** Ultima colonna occupata */
+    int last = game.cols - 1;
+    while (first <= last && cells[first] == EMPTY_CELL) first++;
+    while (last >= first && cells[last] == EMPTY_CELL) last--;
+    /** Hash della sequenza letta da sinistra */
+    unsigned long long forward = 0;
+    /** Hash della sequenza letta da destra */
+    unsigned long long backward = 0;
+    for (int i = 0; i <= last - first; ++i) {
+        forward ^= zobristKey((1ULL << 60) | ((unsigned long long) i << 8) | (unsigned long long) getSideValue(&game, 0, first + i));
+        backward ^= zobristKey((1ULL << 60) | ((unsigned long long) i << 8) | (unsigned long long) getSideValue(&game, 0, last - i));
+    }
+    return hashTileHand(hand) ^ (forward < backward ? forward : backward);
+}
@@ -0,0 +1,48 @@
+/**
+* @file bench.c
+* @author Nicolae Boldisor
+* @brief Programma dei benchmark della modalita' AI: stampa una riga JSON per ogni mano risolta e una con i totali.
+* Le mani sono generate da un seme fisso, quindi due esecuzioni con le stesse opzioni risolvono le stesse mani.
+* @date 17/10/2026
+*/
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char *argv[]) {
+    // Mani da provare e opzioni della modalita' AI da riga di comando
+    benchConfig config = defaultBenchConfig();
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-pruning") == 0) config.options.pruning = false;
+        else if (strcmp(argv[i], "--copy-boards") == 0) config.options.inPlace = false;
+        else if (strcmp(argv[i], "--move-ordering") == 0) config.options.moveOrdering = true;
+        else if (strcmp(argv[i], "--no-trail-solver") == 0) config.options.trailSolver = false;
+        else if (strcmp(argv[i], "--subset-dp") == 0) config.options.subsetDP = true;
+        else if (strcmp(argv[i], "--iterative") == 0) config.options.iterative = true;
+        else if (strcmp(argv[i], "--subset-dp-max-mb") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0) config.options.subsetDPMaxMb = atol(argv[++i]);
+        else if (strcmp(argv[i], "--tablebase") == 0 && i + 1 < argc) config.options.tablebasePath = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) config.options.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ai-budget-ms") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0) config.options.budgetMs = atol(argv[++i]);
+        else if (strcmp(argv[i], "--mcts") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0) config.options.mctsPlayouts = atol(argv[++i]);
+        else if (strcmp(argv[i], "--min-tiles") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 2) config.minTiles = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-tiles") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 2) config.maxTiles = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-specials") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 0) config.maxSpecials = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hands") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) config.hands = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) config.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc && strcmp(argv[i + 1], "2d") == 0) config.mode = BENCH_PLANE, i++;
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc && strcmp(argv[i + 1], "linear") == 0) config.mode = BENCH_LINEAR, i++;
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc && strcmp(argv[i + 1], "both") == 0) config.mode = BENCH_BOTH, i++;
+        else {
+            printf("Opzione sconosciuta: %s\n", argv[i]);
+            printf("Uso: %s [--min-tiles N] [--max-tiles N] [--max-specials N] [--hands N] [--seed N] [--mode 2d|linear|both]"
+                   " [--no-pruning] [--copy-boards] [--move-ordering] [--no-trail-solver] [--subset-dp] [--subset-dp-max-mb N] [--iterative] [--tablebase FILE] [--threads N] [--ai-budget-ms N] [--mcts N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    runBenchmark(config, stdout);
+    return 0;
+}
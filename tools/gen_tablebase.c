@@ -0,0 +1,37 @@
+/**
+* @file gen_tablebase.c
+* @author Nicolae Boldisor
+* @brief Programma che genera il file della tablebase dei finali usata dalla modalita' AI su una sola fila (--linear).
+* @date 17/10/2026
+*/
+
+#include "tablebase.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char *argv[]) {
+    /** Numero massimo di tessere in mano */
+    int maxTiles = DEFAULT_TABLEBASE_TILES;
+    /** File da scrivere */
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-tiles") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 1 && atoi(argv[i + 1]) <= MAX_TABLEBASE_TILES)
+            maxTiles = atoi(argv[++i]);
+        else if (!path && strncmp(argv[i], "--", 2) != 0)
+            path = argv[i];
+        else
+            path = NULL, i = argc;
+    }
+    if (!path) {
+        printf("Uso: %s [--max-tiles N (1-%d)] FILE\n", argv[0], MAX_TABLEBASE_TILES);
+        return 1;
+    }
+
+    if (!writeTablebase(path, maxTiles)) {
+        printf("Impossibile scrivere la tablebase %s\n", path);
+        return 1;
+    }
+    return 0;
+}
@@ -35,13 +35,73 @@
 
 #include "ai.h"
 #include "interactive.h"
+#include "batch.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <stdbool.h>
+#include <string.h>
+
+int main(int argc, char *argv[]) {
+    // Opzioni della modalita' AI da riga di comando
+    aiOptions options = defaultAIOptions();
+    /** Se risolvere le mani lette da file invece di giocare */
+    bool batch = false;
+    /** File da cui leggere le mani in modalita' batch, NULL per lo standard input */
+    const char *batchFile = NULL;
+    for (int i = 1; i < argc; i++) {
+        // --ai (documentata nel README) non cambia niente: la modalita' si sceglie dal menu come senza opzioni
+        if (strcmp(argv[i], "--ai") == 0) continue;
+        else if (strcmp(argv[i], "--no-pruning") == 0) options.pruning = false;
+        else if (strcmp(argv[i], "--copy-boards") == 0) options.inPlace = false;
+        else if (strcmp(argv[i], "--stats") == 0) options.stats = true;
+        else if (strcmp(argv[i], "--moves") == 0) options.printMoves = true;
+        else if (strcmp(argv[i], "--linear") == 0) options.vertical = false;
+        else if (strcmp(argv[i], "--move-ordering") == 0) options.moveOrdering = true;
+        else if (strcmp(argv[i], "--no-trail-solver") == 0) options.trailSolver = false;
+        else if (strcmp(argv[i], "--subset-dp") == 0) options.subsetDP = true;
+        else if (strcmp(argv[i], "--iterative") == 0) options.iterative = true;
+        else if (strcmp(argv[i], "--subset-dp-max-mb") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0) options.subsetDPMaxMb = atol(argv[++i]);
+        else if (strcmp(argv[i], "--tablebase") == 0 && i + 1 < argc) options.tablebasePath = argv[++i];
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "ascii") == 0) {
+            options.outputFormat = OUTPUT_ASCII;
+            i++;
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "rle") == 0) {
+            options.outputFormat = OUTPUT_RLE;
+            i++;
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "json") == 0) {
+            options.outputFormat = OUTPUT_JSON;
+            i++;
+        }
+        else if (strcmp(argv[i], "--batch") == 0) {
+            batch = true;
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) batchFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) options.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ai-budget-ms") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0) options.budgetMs = atol(argv[++i]);
+        else if (strcmp(argv[i], "--mcts") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0) options.mctsPlayouts = atol(argv[++i]);
+        else {
+            printf("Opzione sconosciuta: %s\n", argv[i]);
+            printf("Uso: %s [--no-pruning] [--copy-boards] [--stats] [--moves] [--linear] [--move-ordering] [--no-trail-solver] [--subset-dp] [--subset-dp-max-mb N] [--iterative] [--format ascii|rle|json] [--tablebase FILE] [--threads N] [--ai-budget-ms N] [--mcts N] [--batch [FILE]]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Modalita' batch: una mano per riga, un risultato JSON per riga
+    if (batch) {
+        FILE *in = batchFile ? fopen(batchFile, "r") : stdin;
+        if (!in) {
+            printf("Impossibile aprire il file %s\n", batchFile);
+            return 1;
+        }
+        int errors = runBatch(in, stdout, options);
+        if (batchFile) fclose(in);
+        return errors > 0 ? 1 : 0;
+    }
 
-int main() {
     srand(time(0)); // Random
     int numTotalTiles, numSpecials, choice = 0;
     do {
@@ -76,7 +136,7 @@ int main() {
         case 2:
             printf("--- Hai scelto la modalita' AI! ---\n");
             // Chiama la funzione AI che genera e stampa la miglior sequenza
-            playAI(dominoTiles, numTotalTiles);
+            playAI(dominoTiles, numTotalTiles, options);
             break;
     }
     return 0;
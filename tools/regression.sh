@@ -0,0 +1,123 @@
+#!/bin/sh
+# @file regression.sh
+# @author Nicolae Boldisor
+# @brief Controlli di regressione della modalita' AI fatti con la modalita' batch: le mani sono generate da un seme
+# fisso e i risultati delle diverse ricerche devono essere uguali. Le mani di regression/hands.txt devono dare, con
+# ogni tipo di ricerca, gli stessi campi e le stesse mosse salvati in regression/boards.jsonl (campo normale) e
+# regression/boards_linear.jsonl (una sola fila, senza trail solver). Esce con stato 1 se un controllo fallisce.
+# Uso: tools/regression.sh [DOMINO] [SEME] [MANI] (di default ./domino, seme 1 e 100 mani per controllo)
+# @date 17/10/2026
+
+domino=${1:-./domino}
+seed=${2:-1}
+numHands=${3:-100}
+data=$(dirname "$0")/regression
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+failures=0
+
+# Numero pseudo-casuale da 0 a $1 - 1, con un generatore congruenziale lineare che aggiorna $seed
+nextRandom() {
+    seed=$(( (seed * 1103515245 + 12345) % 2147483648 ))
+    random=$(( (seed / 65536) % $1 ))
+}
+
+# Stampa $1 mani da $2 a $3 tessere con fino a $4 tessere speciali, una per riga, come generateTiles
+randomHands() {
+    hand=0
+    while [ $hand -lt "$1" ]; do
+        nextRandom $(( $3 - $2 + 1 )); numTiles=$(( $2 + random ))
+        nextRandom $(( $4 + 1 )); numSpecials=$random
+        [ $numSpecials -ge $numTiles ] && numSpecials=$(( numTiles - 1 ))
+        line=""
+        tile=0
+        while [ $tile -lt $(( numTiles - numSpecials )) ]; do
+            nextRandom 6; left=$(( random + 1 ))
+            nextRandom $(( 7 - left )); line="$line[$left|$(( random + left ))]"
+            tile=$(( tile + 1 ))
+        done
+        while [ $tile -lt $numTiles ]; do
+            nextRandom 3
+            case $random in
+                0) line="$line[0|0]" ;;
+                1) line="$line[11|11]" ;;
+                2) line="$line[12|21]" ;;
+            esac
+            tile=$(( tile + 1 ))
+        done
+        echo "$line"
+        hand=$(( hand + 1 ))
+    done
+}
+
+# Risolve le mani del file $1 in modalita' batch con le opzioni $2 e stampa il punteggio di ogni mano
+batchScores() {
+    "$domino" --batch "$1" $2 2>/dev/null | sed 's/.*"score":\([0-9]*\).*/\1/'
+}
+
+# Controlla che le mani del file $2 abbiano gli stessi punteggi con le opzioni $3 e con le opzioni $4 (controllo $1)
+compareScores() {
+    batchScores "$2" "$3" > "$tmp/scoresA.txt"
+    batchScores "$2" "$4" > "$tmp/scoresB.txt"
+    if [ -s "$tmp/scoresA.txt" ] && cmp -s "$tmp/scoresA.txt" "$tmp/scoresB.txt"; then
+        echo "ok: $1"
+    else
+        echo "ERRORE: $1 (mano, punteggio con '$3', punteggio con '$4')"
+        paste "$2" "$tmp/scoresA.txt" "$tmp/scoresB.txt" | awk -F '\t' '$2 != $3'
+        failures=$(( failures + 1 ))
+    fi
+}
+
+# Controlla che le mani di regression/hands.txt, con le opzioni $3, diano le righe del file $2 (controllo $1)
+compareBoards() {
+    "$domino" --batch "$data/hands.txt" --moves $3 2>/dev/null | sed 's/,"time_ms":[0-9.]*//' > "$tmp/boards.jsonl"
+    if cmp -s "$tmp/boards.jsonl" "$2"; then
+        echo "ok: $1"
+    else
+        echo "ERRORE: $1 (righe attese e righe ottenute con '$3')"
+        diff "$2" "$tmp/boards.jsonl" | head -20
+        failures=$(( failures + 1 ))
+    fi
+}
+
+if [ ! -x "$domino" ]; then
+    echo "Programma non trovato: $domino"
+    exit 1
+fi
+
+# Su una sola fila e senza tessere speciali il cammino di peso massimo vale quanto la ricerca
+randomHands "$numHands" 2 12 0 > "$tmp/trailHands.txt"
+compareScores "trail solver e ricerca" "$tmp/trailHands.txt" "--linear" "--linear --no-trail-solver"
+
+# Su una sola fila, anche con tessere speciali, la programmazione dinamica vale quanto la ricerca
+randomHands "$numHands" 2 10 3 > "$tmp/dpHands.txt"
+compareScores "programmazione dinamica e ricerca" "$tmp/dpHands.txt" "--linear --subset-dp" "--linear"
+
+# Con una [12|21] e nove tessere normali diverse la tabella supera 1 MB: si deve usare la ricerca
+cat > "$tmp/bigHands.txt" << EOF
+[1|1][1|2][1|3][1|4][1|5][1|6][2|2][2|3][2|4][12|21]
+[2|5][3|3][3|4][3|5][4|4][4|6][5|5][5|6][6|6][12|21]
+[1|2][2|3][3|4][4|5][5|6][1|6][2|6][3|6][1|3][12|21][0|0]
+EOF
+fallbacks=$("$domino" --batch "$tmp/bigHands.txt" --linear --subset-dp --subset-dp-max-mb 1 2>&1 >/dev/null | grep -c "uso la ricerca")
+if [ "$fallbacks" -eq "$(wc -l < "$tmp/bigHands.txt")" ]; then
+    echo "ok: limite di memoria della programmazione dinamica"
+else
+    echo "ERRORE: limite di memoria della programmazione dinamica (ricerca usata per $fallbacks mani su $(wc -l < "$tmp/bigHands.txt"))"
+    failures=$(( failures + 1 ))
+fi
+compareScores "ricerca al posto della programmazione dinamica" "$tmp/bigHands.txt" "--linear --subset-dp --subset-dp-max-mb 1" "--linear --subset-dp"
+
+# Campi e mosse di ogni tipo di ricerca uguali a quelli salvati prima dei cambi di rappresentazione del campo
+compareBoards "campi della ricerca" "$data/boards.jsonl" ""
+compareBoards "campi della ricerca su copie" "$data/boards.jsonl" "--copy-boards"
+compareBoards "campi della ricerca iterativa" "$data/boards.jsonl" "--iterative"
+compareBoards "campi della ricerca su una fila" "$data/boards_linear.jsonl" "--linear --no-trail-solver"
+compareBoards "campi della ricerca su una fila su copie" "$data/boards_linear.jsonl" "--linear --no-trail-solver --copy-boards"
+compareBoards "campi della ricerca iterativa su una fila" "$data/boards_linear.jsonl" "--linear --no-trail-solver --iterative"
+
+if [ $failures -gt 0 ]; then
+    echo "$failures controlli falliti"
+    exit 1
+fi
+echo "Tutti i controlli sono passati"